@@ -0,0 +1,57 @@
+/******************************************************************************
+ * LULESH - Cube Root
+ *
+ * Shared by the per-element, tiled and optimized variants, and checked
+ * against the C library by lulesh_cbrt_test.
+ ******************************************************************************/
+#ifndef LULESH_CBRT_H
+#define LULESH_CBRT_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// Cube root with a fixed operation count, so element loops that call it
+// vectorize. The guess divides the high word of the exponent by 3 (fdlibm's
+// constant, within 3.2%); two Halley steps and one Newton step bring it to
+// within 3 ulp of cbrt(). Magnitudes beyond 2^+-900, where the guess or the
+// cubes would leave the normal range, are scaled by 2^-+300 first. Zero,
+// infinity and NaN come back unchanged, as from cbrt(). Build with
+// -DLULESH_NEWTON_CBRT for the original Newton loop (for TG compatibility)
+// when comparing results.
+#ifndef LULESH_NEWTON_CBRT
+static inline double my_cbrt(double x) {
+    double ax = fabs(x);
+    double scale = (ax < 0x1p-900) ? 0x1p300 : (ax > 0x1p900) ? 0x1p-300 : 1.0;
+    double unscale = (ax < 0x1p-900) ? 0x1p-100 : (ax > 0x1p900) ? 0x1p100 : 1.0;
+    ax *= scale;
+
+    uint64_t bits;
+    memcpy(&bits, &ax, sizeof(bits));
+    bits = (uint64_t)((uint32_t)(bits >> 32) / 3 + 0x2a9f7893u) << 32;
+    double y;
+    memcpy(&y, &bits, sizeof(y));
+
+    double y3 = y * y * y;
+    y = y * (y3 + 2.0 * ax) / (2.0 * y3 + ax);
+    y3 = y * y * y;
+    y = y * (y3 + 2.0 * ax) / (2.0 * y3 + ax);
+    y = y - (y * y * y - ax) / (3.0 * y * y);
+
+    return (x == 0.0 || !isfinite(x)) ? x : copysign(y * unscale, x);
+}
+#else
+static inline double my_cbrt(double x) {
+    if (x == 0.0) return 0.0;
+    double ans = 1.0, old = 0.0;
+    int iter = 0;
+    while (fabs(old - ans) >= PRECISION && iter < 100) {
+        old = ans;
+        ans = (x / (ans * ans) + 2.0 * ans) / 3.0;
+        iter++;
+    }
+    return ans;
+}
+#endif
+
+#endif
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * LULESH - Cube Root Accuracy Test
+ *
+ * Compares my_cbrt with cbrt() on a log-spaced sweep of each sign over the
+ * volumes and Jacobian determinants LULESH takes cube roots of (element
+ * sizes from a 1-element to a MAX_EDGE_ELEMENTS^3 mesh, strongly compressed
+ * or expanded), then over the whole double range and the special values.
+ * Exits non-zero if any result is further than MAX_ULP from cbrt().
+ ******************************************************************************/
+#undef LULESH_NEWTON_CBRT
+#include "lulesh_cbrt.h"
+
+#include <float.h>
+#include <stdio.h>
+
+#define MAX_ULP 4.0
+#define SAMPLES 1000000
+
+static double ulpError(double value, double expected) {
+    if (value == expected)
+        return 0.0;
+    double ulp = nextafter(fabs(expected), INFINITY) - fabs(expected);
+    return fabs(value - expected) / ulp;
+}
+
+static int checkRange(const char *name, double lo, double hi) {
+    double worst = 0.0, worst_x = lo;
+    double log_lo = log(lo), log_hi = log(hi);
+    for (int sign = 1; sign >= -1; sign -= 2) {
+        for (int i = 0; i <= SAMPLES; i++) {
+            double x = sign * fmin(fmax(exp(log_lo + (log_hi - log_lo) * i / SAMPLES), lo), hi);
+            double err = ulpError(my_cbrt(x), cbrt(x));
+            if (!(err <= worst)) {
+                worst = err;
+                worst_x = x;
+            }
+        }
+    }
+    int ok = worst <= MAX_ULP;
+    printf("%-8s [%9.3g, %9.3g]: max %.2f ulp at %.17g %s\n", name, lo, hi, worst, worst_x,
+           ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static int checkSpecial(double x) {
+    double value = my_cbrt(x), expected = cbrt(x);
+    int ok = (isnan(expected) && isnan(value)) ||
+             (value == expected && signbit(value) == signbit(expected)) ||
+             (isfinite(expected) && ulpError(value, expected) <= MAX_ULP);
+    if (!ok)
+        printf("my_cbrt(%.17g) = %.17g, cbrt gives %.17g FAILED\n", x, value, expected);
+    return ok;
+}
+
+int main(void) {
+    int ok = 1;
+    ok &= checkRange("LULESH", 1.0e-12, 1.0e6);
+    ok &= checkRange("normal", DBL_MIN, DBL_MAX);
+    ok &= checkRange("tiny", DBL_TRUE_MIN, DBL_MIN);
+
+    const double special[] = {0.0, -0.0, INFINITY, -INFINITY, NAN, DBL_TRUE_MIN, -DBL_TRUE_MIN,
+                              DBL_MIN, DBL_MAX, -DBL_MAX, 1.0, -1.0, 8.0, -27.0};
+    for (size_t i = 0; i < sizeof(special) / sizeof(special[0]); i++)
+        ok &= checkSpecial(special[i]);
+
+    printf("%s\n", ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -40,8 +40,16 @@
 #define MAX_ELEMENT_TILES ((MAX_ELEMENTS + TILE_SIZE - 1) / TILE_SIZE)
 #define MAX_NODE_TILES ((MAX_NODES + TILE_SIZE - 1) / TILE_SIZE)
 
+// Precision for the Newton cube root (-DLULESH_NEWTON_CBRT)
 #define PRECISION 1.0e-10
 
+// Node/element numbering applied at mesh build time
+typedef enum MeshOrdering {
+    MESH_ORDER_LEXICOGRAPHIC = 0,
+    MESH_ORDER_MORTON,
+    MESH_ORDER_HILBERT
+} MeshOrdering;
+
 /*============================================================================
  * Runtime Configuration
  *============================================================================*/
@@ -56,10 +64,108 @@ typedef struct RuntimeConfig {
     int tile_size;
     int num_element_tiles;
     int num_node_tiles;
+    int replay_graph;
+    int mesh_ordering;
+    int auto_tune;
+    int profile;
+    int first_touch;
+    int checkpoint_interval;
+    const char *checkpoint_file;
+    const char *restart_file;
+    int restart_iteration;
 } RuntimeConfig;
 
 extern RuntimeConfig g_config;
 
+/*============================================================================
+ * Iteration Graph Template (capture once, replay every iteration)
+ *
+ * The per-iteration task graph is identical from one timestep to the next,
+ * so it is recorded as a list of phases on the first iteration. Each phase
+ * spawns num_edts EDTs per tile and counts them down on one latch; phases
+ * with several predecessors wait on a combined latch.
+ *============================================================================*/
+
+#define MAX_GRAPH_PHASES 16
+#define MAX_PHASE_EDTS 2
+#define MAX_PHASE_DEPS 3
+
+typedef struct GraphPhase {
+    const char *name;
+    artsEdt_t edts[MAX_PHASE_EDTS];
+    int num_edts;
+    int num_items;
+    int num_tiles;
+    int tile_size;
+    int num_deps;
+    int deps[MAX_PHASE_DEPS];
+} GraphPhase;
+
+typedef struct IterationGraph {
+    int num_phases;
+    int num_latches;
+    int sink_phase;
+    GraphPhase phases[MAX_GRAPH_PHASES];
+} IterationGraph;
+
+// Launch overhead accounting (nanoseconds)
+typedef struct LaunchStats {
+    uint64_t capture_ns;
+    uint64_t critical_ns;
+    uint64_t background_ns;
+    int launches;
+} LaunchStats;
+
+extern IterationGraph g_graph;
+extern LaunchStats g_launch;
+
+/*============================================================================
+ * Tile-Size Auto-Tuning (-A)
+ *
+ * Trial iterations run every phase with the same candidate tile size and
+ * time each phase from its release to its done latch. Phases are separated
+ * by latches, so each one keeps its own fastest candidate afterwards.
+ *============================================================================*/
+
+#define MAX_TUNE_CANDIDATES 8
+#define TUNE_MIN_TILE 64
+#define TUNE_REPEATS 2
+
+typedef struct TileTuner {
+    int phase_tile[MAX_GRAPH_PHASES];
+    int num_candidates;
+    int candidates[MAX_TUNE_CANDIDATES];
+    int trial;
+    int done;
+    int iterations;
+    uint64_t first_ns;
+    uint64_t tuning_ns;
+    uint64_t start_ns;
+    uint64_t phase_end_ns[MAX_GRAPH_PHASES];
+    uint64_t best_ns[MAX_GRAPH_PHASES];
+} TileTuner;
+
+extern TileTuner g_tuner;
+
+/*============================================================================
+ * Phase Profiling (-P)
+ *
+ * Tile EDTs stamp their start and end into per-worker buffers, so workers
+ * never share a cache line while recording. computeDeltaTimeEdt folds the
+ * buffers once per iteration, using the graph template for phase order.
+ *============================================================================*/
+
+void profileRecordTile(int phase_id, uint64_t start_ns);
+
+static inline uint64_t profileTileBegin(void) {
+    return g_config.profile ? artsGetTimeStamp() : 0;
+}
+
+static inline void profileTileEnd(int phase_id, uint64_t start_ns) {
+    if (start_ns)
+        profileRecordTile(phase_id, start_ns);
+}
+
 /*============================================================================
  * Basic Types
  *============================================================================*/
@@ -114,6 +220,7 @@ struct mesh {
     int nodes_element_neighbors[MAX_NODES][8];
     int elements_node_neighbors[MAX_ELEMENTS][8];
     int elements_element_neighbors[MAX_ELEMENTS][6];
+    int element_lex_map[MAX_ELEMENTS];
 };
 
 /*============================================================================
@@ -257,17 +364,8 @@ static inline vector cross(vector a, vector b) {
                     a.x * b.y - a.y * b.x};
 }
 
-static inline double my_cbrt(double x) {
-    if (x == 0.0) return 0.0;
-    double ans = 1.0, old = 0.0;
-    int iter = 0;
-    while (fabs(old - ans) >= PRECISION && iter < 100) {
-        old = ans;
-        ans = (x / (ans * ans) + 2.0 * ans) / 3.0;
-        iter++;
-    }
-    return ans;
-}
+// Cube root shared by all variants (see common/lulesh_cbrt.h)
+#include "lulesh_cbrt.h"
 
 /*============================================================================
  * Index Calculation Helpers
@@ -311,9 +409,58 @@ void volumeAndDerivedTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc,
 void energyAndConstraintsTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
 void computeDeltaTimeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
 
+// Graph capture/replay
+void instantiateIterationEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+int graphAddPhase(IterationGraph *graph, const char *name, artsEdt_t edt0, artsEdt_t edt1,
+                  int num_items, int num_deps, const int *deps);
+void captureIterationGraph(IterationGraph *graph);
+void instantiateIterationGraph(const IterationGraph *graph, int iteration,
+                               artsGuid_t startEvent, artsGuid_t nextStartEvent);
+void launchNextIteration(int iteration, artsGuid_t nextStartEvent, luleshCtx *ctx);
+void printLaunchStatistics(double elapsed_wall_time);
+
+// Tile-size auto-tuning
+void phaseTimerEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+int parseTileSizes(const char *list);
+void initTileTuner(luleshCtx *ctx);
+int phaseTileSize(int phase_id);
+int tuneActive(void);
+int tuneTiming(void);
+void tuneBeginIteration(void);
+artsGuid_t tuneTimePhase(int phase_id, artsGuid_t doneEvent);
+void instantiateTimedIteration(int iteration);
+void printTileConfig(void);
+
+// Phase profiling
+void profileInit(void);
+void profileIterationStart(void);
+void profileEndIteration(uint64_t start_ns);
+void printPhaseProfile(double elapsed_wall_time);
+
+// NUMA first-touch initialization
+void initializeNodeRange(luleshCtx *ctx, int start, int end);
+void initializeElementRange(luleshCtx *ctx, int start, int end);
+void firstTouchTileEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+void beginSimulationEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+void firstTouchInitialize(luleshCtx *ctx);
+void beginSimulation(luleshCtx *ctx);
+void printMemoryPlacement(luleshCtx *ctx);
+
+// Checkpoint/restart
+void checkpointIteration(int iteration, luleshCtx *ctx);
+void checkpointWriteEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+int checkpointDeferShutdown(void);
+int restartFromCheckpoint(luleshCtx *ctx);
+void printCheckpointStatistics(int iterations);
+
 // Helper functions
 void initGraphContext(luleshCtx *ctx);
 void startIteration(int iteration, luleshCtx *ctx);
+void printIterationInfo(int iteration);
+int parseMeshOrdering(const char *name);
+const char *meshOrderingName(int ordering);
+void renumberMesh(luleshCtx *ctx, int ordering);
+void printMeshOrdering(luleshCtx *ctx);
 void parseCommandLine(int argc, char **argv);
 void printUsage(const char *progname);
 
@@ -0,0 +1,225 @@
+/******************************************************************************
+ * LULESH Optimized - Checkpoint/Restart
+ *
+ * Iteration N+1 reads only the node, element and timing data that iteration
+ * N left in buffer N % 2, so that buffer alone is a complete restart point.
+ * Every -C iterations computeDeltaTimeEdt copies it into a staging area
+ * (the only part on the critical path) and hands it to checkpointWriteEdt,
+ * which any idle worker picks up while the next iteration proceeds.
+ *
+ * Files are written to <file>.tmp, synced and renamed, so a crash during a
+ * write leaves the previous checkpoint intact. If a write is still running
+ * when the next checkpoint is due, that checkpoint is skipped. If one is
+ * running at the end of the run, the writer calls artsShutdown instead.
+ ******************************************************************************/
+// fileno is POSIX, not C17
+#define _POSIX_C_SOURCE 200809L
+#include "lulesh.h"
+#include <unistd.h>
+
+#define CHECKPOINT_MAGIC 0x4b435053454c554cull   // "LULESPCK"
+#define CHECKPOINT_VERSION 1
+
+enum { CHECKPOINT_IDLE = 0, CHECKPOINT_WRITING, CHECKPOINT_SHUTDOWN };
+
+typedef struct CheckpointHeader {
+    uint64_t magic;
+    uint32_t version;
+    int32_t edge_elements;
+    int32_t mesh_ordering;
+    int32_t iteration;
+    int32_t nodes;
+    int32_t elements;
+    uint32_t node_bytes;
+    uint32_t element_bytes;
+    double dt;
+    double elapsed;
+} CheckpointHeader;
+
+typedef struct CheckpointState {
+    int state;                  // CHECKPOINT_* (atomic)
+    CheckpointHeader header;
+    NodeData *nodes;            // Staging copy of the active buffer
+    ElementData *elements;
+    int written;
+    int skipped;
+    int failed;
+    uint64_t bytes;
+    uint64_t copy_ns;           // Critical path: snapshot into staging
+    uint64_t write_ns;          // Background: file write + sync
+} CheckpointState;
+
+static CheckpointState g_checkpoint = {0};
+
+/*============================================================================
+ * Snapshot (critical path)
+ *============================================================================*/
+
+void checkpointIteration(int iteration, luleshCtx *ctx) {
+    if (g_config.checkpoint_interval <= 0 || iteration % g_config.checkpoint_interval != 0)
+        return;
+
+    // One write in flight at a time; the staging area is reused
+    int idle = CHECKPOINT_IDLE;
+    if (!__atomic_compare_exchange_n(&g_checkpoint.state, &idle, CHECKPOINT_WRITING, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        g_checkpoint.skipped++;
+        return;
+    }
+
+    uint64_t t0 = artsGetTimeStamp();
+    int buf = iteration % 2;
+
+    if (!g_checkpoint.nodes) {
+        g_checkpoint.nodes = (NodeData *)malloc(sizeof(NodeData) * ctx->nodes);
+        g_checkpoint.elements = (ElementData *)malloc(sizeof(ElementData) * ctx->elements);
+        assert(g_checkpoint.nodes && g_checkpoint.elements);
+    }
+
+    g_checkpoint.header = (CheckpointHeader){
+        .magic = CHECKPOINT_MAGIC,
+        .version = CHECKPOINT_VERSION,
+        .edge_elements = g_config.edge_elements,
+        .mesh_ordering = g_config.mesh_ordering,
+        .iteration = iteration,
+        .nodes = ctx->nodes,
+        .elements = ctx->elements,
+        .node_bytes = sizeof(NodeData),
+        .element_bytes = sizeof(ElementData),
+        .dt = timingData[buf]->dt,
+        .elapsed = timingData[buf]->elapsed
+    };
+    memcpy(g_checkpoint.nodes, allNodeData[buf], sizeof(NodeData) * ctx->nodes);
+    memcpy(g_checkpoint.elements, allElementData[buf], sizeof(ElementData) * ctx->elements);
+
+    g_checkpoint.copy_ns += artsGetTimeStamp() - t0;
+
+    artsEdtCreate(checkpointWriteEdt, 0, 0, NULL, 0);
+}
+
+/*============================================================================
+ * File Write (background)
+ *============================================================================*/
+
+static int writeCheckpointFile(const char *path) {
+    const CheckpointHeader *header = &g_checkpoint.header;
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (!file)
+        return 0;
+
+    int ok = fwrite(header, sizeof(CheckpointHeader), 1, file) == 1 &&
+             fwrite(g_checkpoint.nodes, sizeof(NodeData), header->nodes, file) == (size_t)header->nodes &&
+             fwrite(g_checkpoint.elements, sizeof(ElementData), header->elements, file) == (size_t)header->elements &&
+             fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = (fclose(file) == 0) && ok;
+
+    return ok && rename(tmp_path, path) == 0;
+}
+
+void checkpointWriteEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    uint64_t t0 = artsGetTimeStamp();
+
+    if (writeCheckpointFile(g_config.checkpoint_file)) {
+        g_checkpoint.written++;
+        g_checkpoint.bytes = sizeof(CheckpointHeader) +
+                             sizeof(NodeData) * (uint64_t)g_checkpoint.header.nodes +
+                             sizeof(ElementData) * (uint64_t)g_checkpoint.header.elements;
+    } else {
+        fprintf(stderr, "Error: checkpoint of iteration %d to %s failed\n",
+                g_checkpoint.header.iteration, g_config.checkpoint_file);
+        g_checkpoint.failed++;
+    }
+
+    g_checkpoint.write_ns += artsGetTimeStamp() - t0;
+
+    // If the run ended while writing, shutting down was left to us
+    int writing = CHECKPOINT_WRITING;
+    if (!__atomic_compare_exchange_n(&g_checkpoint.state, &writing, CHECKPOINT_IDLE, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        artsShutdown();
+    }
+}
+
+// Called instead of artsShutdown at the end of the run; returns 1 if a
+// write is still in flight and will shut the runtime down when it lands
+int checkpointDeferShutdown(void) {
+    int writing = CHECKPOINT_WRITING;
+    return __atomic_compare_exchange_n(&g_checkpoint.state, &writing, CHECKPOINT_SHUTDOWN, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/*============================================================================
+ * Restart
+ *============================================================================*/
+
+// Loads the checkpoint into buffer iteration % 2 and returns that iteration
+int restartFromCheckpoint(luleshCtx *ctx) {
+    const char *path = g_config.restart_file;
+    CheckpointHeader header;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: cannot open checkpoint %s\n", path);
+        exit(1);
+    }
+
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||
+        header.node_bytes != sizeof(NodeData) || header.element_bytes != sizeof(ElementData)) {
+        fprintf(stderr, "Error: %s is not a LULESH checkpoint\n", path);
+        exit(1);
+    }
+    if (header.edge_elements != g_config.edge_elements || header.mesh_ordering != g_config.mesh_ordering ||
+        header.nodes != ctx->nodes || header.elements != ctx->elements) {
+        fprintf(stderr, "Error: checkpoint %s is for -s %d -O %s\n", path,
+                header.edge_elements, meshOrderingName(header.mesh_ordering));
+        exit(1);
+    }
+
+    int buf = header.iteration % 2;
+    if (fread(allNodeData[buf], sizeof(NodeData), header.nodes, file) != (size_t)header.nodes ||
+        fread(allElementData[buf], sizeof(ElementData), header.elements, file) != (size_t)header.elements) {
+        fprintf(stderr, "Error: checkpoint %s is truncated\n", path);
+        exit(1);
+    }
+    fclose(file);
+
+    timingData[buf]->dt = header.dt;
+    timingData[buf]->elapsed = header.elapsed;
+    g_config.restart_iteration = header.iteration;
+
+    if (header.iteration >= g_config.max_iterations || header.elapsed >= g_config.stop_time) {
+        fprintf(stderr, "Error: checkpoint %s (iteration %d, time %e) is already past -i/-t\n",
+                path, header.iteration, header.elapsed);
+        exit(1);
+    }
+
+    if (!g_config.quiet)
+        PRINTF("Restarting from %s at iteration %d (time %e)\n\n", path, header.iteration, header.elapsed);
+
+    return header.iteration;
+}
+
+/*============================================================================
+ * Report
+ *============================================================================*/
+
+void printCheckpointStatistics(int iterations) {
+    if (g_config.checkpoint_interval <= 0)
+        return;
+
+    double copy = (double)g_checkpoint.copy_ns / 1.0e9;
+    int in_flight = __atomic_load_n(&g_checkpoint.state, __ATOMIC_ACQUIRE) != CHECKPOINT_IDLE;
+
+    PRINTF("Checkpoints          = %d written, %d skipped, %d failed%s (every %d iterations, %.1f MB each)\n",
+           g_checkpoint.written, g_checkpoint.skipped, g_checkpoint.failed,
+           in_flight ? ", 1 in flight" : "", g_config.checkpoint_interval,
+           (double)g_checkpoint.bytes / (1024.0 * 1024.0));
+    PRINTF("Checkpoint overhead  = %10.6f (s)  %8.3f (us/iter) on critical path\n",
+           copy, iterations > 0 ? copy * 1.0e6 / iterations : 0.0);
+    PRINTF("Checkpoint writes    = %10.6f (s)  (overlapped with compute)\n\n",
+           (double)g_checkpoint.write_ns / 1.0e9);
+}
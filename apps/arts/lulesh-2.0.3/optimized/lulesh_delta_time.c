@@ -3,8 +3,6 @@
  ******************************************************************************/
 #include "lulesh.h"
 
-void startIteration(int iteration, luleshCtx *ctx);
-
 static void printFinalStatistics(int iteration, double elapsed_sim_time,
                                  double delta_time, luleshCtx *ctx) {
     int nx = g_config.edge_elements;
@@ -12,11 +10,13 @@ static void printFinalStatistics(int iteration, double elapsed_sim_time,
     uint64_t end_time = artsGetTimeStamp();
     double elapsed_wall_time = (double)(end_time - g_config.start_time) / 1.0e9;
 
-    double grindTime1 = ((elapsed_wall_time * 1.0e6) / iteration) / (nx * nx * nx);
+    // Only the iterations run by this process count after a restart
+    int cycles = iteration - g_config.restart_iteration;
+    double grindTime1 = ((elapsed_wall_time * 1.0e6) / cycles) / (nx * nx * nx);
     double grindTime2 = grindTime1;
 
     int curr_buf = iteration % 2;
-    double origin_energy = allElementData[curr_buf][0].energy;
+    double origin_energy = allElementData[curr_buf][ctx->mesh.element_lex_map[0]].energy;
 
     double MaxAbsDiff = 0.0;
     double TotalAbsDiff = 0.0;
@@ -24,8 +24,8 @@ static void printFinalStatistics(int iteration, double elapsed_sim_time,
 
     for (int j = 0; j < nx; ++j) {
         for (int k = j + 1; k < nx; ++k) {
-            double e_jk = allElementData[curr_buf][j * nx + k].energy;
-            double e_kj = allElementData[curr_buf][k * nx + j].energy;
+            double e_jk = allElementData[curr_buf][ctx->mesh.element_lex_map[j * nx + k]].energy;
+            double e_kj = allElementData[curr_buf][ctx->mesh.element_lex_map[k * nx + j]].energy;
             double AbsDiff = fabs(e_jk - e_kj);
             TotalAbsDiff += AbsDiff;
 
@@ -55,10 +55,19 @@ static void printFinalStatistics(int iteration, double elapsed_sim_time,
     PRINTF("Grind time (us/z/c)  = %10.8g (per dom)  (%10.8g overall)\n",
            grindTime1, grindTime2);
     PRINTF("FOM                  = %10.8g (z/s)\n\n", 1000.0 / grindTime2);
+
+    printLaunchStatistics(elapsed_wall_time);
+    printTileConfig();
+    printPhaseProfile(elapsed_wall_time);
+    printCheckpointStatistics(cycles);
+    printMeshOrdering(ctx);
+    printMemoryPlacement(ctx);
 }
 
 void computeDeltaTimeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
     int iteration = (int)paramv[0];
+    artsGuid_t nextStartEvent = (artsGuid_t)paramv[1];
+    uint64_t t0 = profileTileBegin();
     
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
@@ -130,11 +139,15 @@ void computeDeltaTimeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsE
     timingData[curr_buf]->dt = delta_time;
     timingData[curr_buf]->elapsed = elapsed_time;
     
+    profileEndIteration(t0);
+    checkpointIteration(iteration, ctx);
+
     int maxiter = ctx->constraints.maximum_iterations;
     if (iteration >= maxiter || elapsed_time >= stop_time) {
         printFinalStatistics(iteration, elapsed_time, delta_time, ctx);
-        artsShutdown();
+        if (!checkpointDeferShutdown())
+            artsShutdown();
     } else {
-        startIteration(iteration + 1, ctx);
+        launchNextIteration(iteration, nextStartEvent, ctx);
     }
 }
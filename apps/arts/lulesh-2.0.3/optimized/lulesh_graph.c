@@ -0,0 +1,158 @@
+/******************************************************************************
+ * LULESH Optimized - Iteration Graph Capture and Replay
+ *
+ * Without replay, computeDeltaTimeEdt rebuilds the next iteration (latches,
+ * tile EDTs and dependences) before any of it can run, so the whole launch
+ * sits on the critical path between timesteps.
+ *
+ * With replay (-R), the graph captured on iteration 1 is instantiated one
+ * iteration ahead by instantiateIterationEdt, overlapped with the compute
+ * of the current iteration. Its first phase is gated on a start event, and
+ * launching the next timestep only costs satisfying that event.
+ ******************************************************************************/
+#include "lulesh.h"
+
+IterationGraph g_graph = {0};
+LaunchStats g_launch = {0};
+
+/*============================================================================
+ * Template Construction
+ *============================================================================*/
+
+int graphAddPhase(IterationGraph *graph, const char *name, artsEdt_t edt0, artsEdt_t edt1,
+                  int num_items, int num_deps, const int *deps) {
+    assert(graph->num_phases < MAX_GRAPH_PHASES);
+    assert(num_deps <= MAX_PHASE_DEPS);
+
+    int phase_id = graph->num_phases++;
+    GraphPhase *phase = &graph->phases[phase_id];
+
+    phase->name = name;
+    phase->edts[0] = edt0;
+    phase->edts[1] = edt1;
+    phase->num_edts = edt1 ? 2 : 1;
+    phase->num_items = num_items;
+    phase->tile_size = phaseTileSize(phase_id);
+    phase->num_tiles = (num_items + phase->tile_size - 1) / phase->tile_size;
+    phase->num_deps = num_deps;
+    for (int i = 0; i < num_deps; i++) {
+        assert(deps[i] < phase_id);
+        phase->deps[i] = deps[i];
+    }
+
+    // One done latch per phase, plus a combined latch when joining phases
+    graph->num_latches += (num_deps > 1) ? 2 : 1;
+    graph->sink_phase = phase_id;
+    return phase_id;
+}
+
+/*============================================================================
+ * Instantiate One Iteration From the Template
+ *============================================================================*/
+
+void instantiateIterationGraph(const IterationGraph *graph, int iteration,
+                               artsGuid_t startEvent, artsGuid_t nextStartEvent) {
+    artsGuid_t doneEvents[MAX_GRAPH_PHASES];
+
+    for (int phase_id = 0; phase_id < graph->num_phases; phase_id++) {
+        const GraphPhase *phase = &graph->phases[phase_id];
+
+        // Resolve what this phase waits on: the iteration start, a single
+        // predecessor latch, or a combined latch over several predecessors
+        artsGuid_t waitEvent = startEvent;
+        if (phase->num_deps == 1) {
+            waitEvent = doneEvents[phase->deps[0]];
+        } else if (phase->num_deps > 1) {
+            waitEvent = artsEventCreate(0, phase->num_deps);
+            for (int i = 0; i < phase->num_deps; i++) {
+                artsAddDependence(doneEvents[phase->deps[i]], waitEvent,
+                                  ARTS_EVENT_LATCH_DECR_SLOT);
+            }
+        }
+
+        doneEvents[phase_id] = artsEventCreate(0, phase->num_tiles * phase->num_edts);
+
+        uint32_t depc = (waitEvent != NULL_GUID) ? 1 : 0;
+        for (int tile_id = 0; tile_id < phase->num_tiles; tile_id++) {
+            uint64_t params[5] = {iteration, tile_id, (uint64_t)doneEvents[phase_id],
+                                  phase->tile_size, phase_id};
+            for (int e = 0; e < phase->num_edts; e++) {
+                artsGuid_t edtGuid = artsEdtCreate(phase->edts[e], 0, 5, params, depc);
+                if (depc)
+                    artsAddDependence(waitEvent, edtGuid, 0);
+            }
+        }
+
+        // Auto-tune trials route the latch through a timestamp EDT
+        if (tuneTiming())
+            doneEvents[phase_id] = tuneTimePhase(phase_id, doneEvents[phase_id]);
+    }
+
+    // Delta time reduction closes the iteration and releases the next one
+    uint64_t params[2] = {iteration, (uint64_t)nextStartEvent};
+    artsGuid_t edtGuid = artsEdtCreate(computeDeltaTimeEdt, 0, 2, params, 1);
+    artsAddDependence(doneEvents[graph->sink_phase], edtGuid, 0);
+}
+
+/*============================================================================
+ * Replay: build iteration N+1 while iteration N computes
+ *============================================================================*/
+
+void instantiateIterationEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    artsGuid_t startEvent = (artsGuid_t)paramv[1];
+
+    uint64_t t0 = artsGetTimeStamp();
+
+    artsGuid_t nextStartEvent = NULL_GUID;
+    if (iteration < g_config.max_iterations)
+        nextStartEvent = artsEventCreate(0, 1);
+
+    instantiateIterationGraph(&g_graph, iteration, startEvent, nextStartEvent);
+
+    g_launch.background_ns += artsGetTimeStamp() - t0;
+
+    // Instantiate the following iteration once this one has been released
+    if (nextStartEvent != NULL_GUID) {
+        uint64_t params[2] = {iteration + 1, (uint64_t)nextStartEvent};
+        artsGuid_t edtGuid = artsEdtCreate(instantiateIterationEdt, 0, 2, params, 1);
+        artsAddDependence(startEvent, edtGuid, 0);
+    }
+}
+
+/*============================================================================
+ * Launch the Next Iteration (called from computeDeltaTimeEdt)
+ *============================================================================*/
+
+void launchNextIteration(int iteration, artsGuid_t nextStartEvent, luleshCtx *ctx) {
+    uint64_t t0 = artsGetTimeStamp();
+
+    if (nextStartEvent != NULL_GUID) {
+        printIterationInfo(iteration + 1);
+        profileIterationStart();
+        artsEventSatisfySlot(nextStartEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
+    } else {
+        startIteration(iteration + 1, ctx);
+    }
+
+    g_launch.critical_ns += artsGetTimeStamp() - t0;
+    g_launch.launches++;
+}
+
+void printLaunchStatistics(double elapsed_wall_time) {
+    double critical = (double)g_launch.critical_ns / 1.0e9;
+    double per_launch = g_launch.launches ? critical * 1.0e6 / g_launch.launches : 0.0;
+    double fraction = elapsed_wall_time > 0.0 ? 100.0 * critical / elapsed_wall_time : 0.0;
+
+    PRINTF("Graph mode           = %s (%d phases, %d latches per iteration)\n",
+           g_config.replay_graph ? "replay" : "rebuild",
+           g_graph.num_phases, g_graph.num_latches);
+    PRINTF("Graph capture        = %10.6f (s)\n", (double)g_launch.capture_ns / 1.0e9);
+    PRINTF("Launch overhead      = %10.6f (s)  %8.3f (us/iter)  %6.2f%% of elapsed\n",
+           critical, per_launch, fraction);
+    if (g_config.replay_graph) {
+        PRINTF("Replay instantiation = %10.6f (s)  (overlapped with compute)\n",
+               (double)g_launch.background_ns / 1.0e9);
+    }
+    PRINTF("\n");
+}
@@ -84,13 +84,16 @@ void reduceAndKinematicsTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t dep
     int iteration = (int)paramv[0];
     int tile_id = (int)paramv[1];
     artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int tile_size = (int)paramv[3];
+    int phase_id = (int)paramv[4];
+    uint64_t t0 = profileTileBegin();
     
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
     double dt = timingData[prev_buf]->dt;
     
     int start, end;
-    getTileRange(tile_id, ctx->nodes, g_config.tile_size, &start, &end);
+    getTileRange(tile_id, ctx->nodes, tile_size, &start, &end);
     
     for (int node_id = start; node_id < end; node_id++) {
         // Fused: reduce force, then compute velocity, then compute position
@@ -99,5 +102,6 @@ void reduceAndKinematicsTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t dep
         computePositionForNode(iteration, node_id, dt, ctx);
     }
     
+    profileTileEnd(phase_id, t0);
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
 }
@@ -4,6 +4,11 @@
  *   1. DB Reuse: Pre-allocate all DBs once
  *   2. Phase Fusion: 5 phases instead of 12
  *   3. Reduced Events: Only 4 synchronization points per iteration
+ *   4. Graph Replay: Capture the iteration graph once, replay it ahead (-R)
+ *   5. Tile Auto-Tuning: Per-phase tile sizes picked from timed iterations (-A)
+ *   6. Phase Profiling: Per-phase/per-tile timing report at shutdown (-P)
+ *   7. Checkpoint/Restart: Asynchronous snapshots, exact resume (-C, -restart)
+ *   8. NUMA First-Touch: Initial conditions written by tiled EDTs (-N)
  ******************************************************************************/
 #include "lulesh.h"
 #include <getopt.h>
@@ -24,7 +29,16 @@ RuntimeConfig g_config = {
     .start_time = 0,
     .tile_size = TILE_SIZE,
     .num_element_tiles = 0,
-    .num_node_tiles = 0
+    .num_node_tiles = 0,
+    .replay_graph = 0,
+    .mesh_ordering = MESH_ORDER_LEXICOGRAPHIC,
+    .auto_tune = 0,
+    .profile = 0,
+    .first_touch = 0,
+    .checkpoint_interval = 0,
+    .checkpoint_file = "lulesh.ckpt",
+    .restart_file = NULL,
+    .restart_iteration = 0
 };
 
 // Pre-allocated arrays (double buffered) - SINGLE allocation per buffer!
@@ -54,17 +68,32 @@ void printUsage(const char *progname) {
            DEFAULT_EDGE_ELEMENTS, MAX_EDGE_ELEMENTS);
     printf("  -i <iter>    Maximum iterations (default: 9999999)\n");
     printf("  -t <time>    Stop time (default: 1.0e-2)\n");
-    printf("  -T <tile>    Tile size (elements/nodes per task, default: %d)\n", TILE_SIZE);
+    printf("  -T <tile>    Tile size (elements/nodes per task, default: %d);\n", TILE_SIZE);
+    printf("               a comma-separated list sets one size per phase\n");
+    printf("  -A           Auto-tune per-phase tile sizes over the first iterations\n");
+    printf("  -P           Report per-phase/per-tile timing at shutdown\n");
+    printf("  -C <n>       Checkpoint every n iterations (default: off)\n");
+    printf("  -F <file>    Checkpoint file (default: lulesh.ckpt)\n");
+    printf("  -restart <file>  Resume from a checkpoint (same -s and -O)\n");
+    printf("  -R           Capture the iteration graph once and replay it\n");
+    printf("  -O <order>   Node/element ordering: lex, morton, hilbert (default: lex)\n");
+    printf("  -N           Initialize data in tiled EDTs (NUMA first-touch)\n");
     printf("  -p           Show iteration progress (default: on)\n");
     printf("  -q           Quiet mode (minimal output)\n");
     printf("  -h           Show this help message\n");
 }
 
+static const struct option long_options[] = {
+    {"restart", required_argument, NULL, 'X'},
+    {NULL, 0, NULL, 0}
+};
+
 void parseCommandLine(int argc, char **argv) {
     int opt;
     optind = 1;
     
-    while ((opt = getopt(argc, argv, "s:i:t:T:pqh")) != -1) {
+    // getopt_long_only so that -restart works with a single dash
+    while ((opt = getopt_long_only(argc, argv, "s:i:t:T:ARO:NPC:F:pqh", long_options, NULL)) != -1) {
         switch (opt) {
             case 's':
                 g_config.edge_elements = atoi(optarg);
@@ -92,10 +121,40 @@ void parseCommandLine(int argc, char **argv) {
                 }
                 break;
             case 'T':
-                g_config.tile_size = atoi(optarg);
-                if (g_config.tile_size < 1) {
-                    fprintf(stderr, "Error: tile size must be at least 1\n");
-                    g_config.tile_size = TILE_SIZE;
+                if (parseTileSizes(optarg) < 0) {
+                    fprintf(stderr, "Error: tile sizes must be positive integers separated by commas\n");
+                }
+                break;
+            case 'A':
+                g_config.auto_tune = 1;
+                break;
+            case 'P':
+                g_config.profile = 1;
+                break;
+            case 'C':
+                g_config.checkpoint_interval = atoi(optarg);
+                if (g_config.checkpoint_interval < 0) {
+                    fprintf(stderr, "Error: checkpoint interval must be non-negative\n");
+                    g_config.checkpoint_interval = 0;
+                }
+                break;
+            case 'F':
+                g_config.checkpoint_file = optarg;
+                break;
+            case 'X':
+                g_config.restart_file = optarg;
+                break;
+            case 'R':
+                g_config.replay_graph = 1;
+                break;
+            case 'N':
+                g_config.first_touch = 1;
+                break;
+            case 'O':
+                g_config.mesh_ordering = parseMeshOrdering(optarg);
+                if (g_config.mesh_ordering < 0) {
+                    fprintf(stderr, "Error: unknown ordering '%s' (lex, morton, hilbert)\n", optarg);
+                    g_config.mesh_ordering = MESH_ORDER_LEXICOGRAPHIC;
                 }
                 break;
             case 'p':
@@ -130,6 +189,7 @@ void initGraphContext(luleshCtx *ctx) {
 
     g_config.num_element_tiles = (elements + g_config.tile_size - 1) / g_config.tile_size;
     g_config.num_node_tiles = (nodes + g_config.tile_size - 1) / g_config.tile_size;
+    initTileTuner(ctx);
 
     ctx->constants = (struct constants){
         3.0, 4.0/3.0, 1.0e+12, 1.0, 2.0, 0.5, 2.0/3.0,
@@ -266,6 +326,8 @@ void initGraphContext(luleshCtx *ctx) {
 
     double delta_time = 0.5 * my_cbrt(ctx->domain.element_volume[0]) / sqrt(2.0 * einit);
     ctx->domain.initial_delta_time = delta_time;
+
+    renumberMesh(ctx, g_config.mesh_ordering);
 }
 
 /*============================================================================
@@ -300,14 +362,34 @@ void initializeAllDataBlocks(luleshCtx *ctx) {
                                             sizeof(TimingData), ARTS_DB_PIN);
     }
 
-    // Initialize buffer 0 with initial conditions
-    for (int node_id = 0; node_id < nodes; node_id++) {
+    timingData[0]->dt = ctx->domain.initial_delta_time;
+    timingData[0]->elapsed = 0.0;
+
+    // Buffer 1 is first written by the iteration 1 tiles. With -N, buffer 0
+    // is also left untouched here and filled by firstTouchTileEdt.
+    if (!g_config.first_touch) {
+        initializeNodeRange(ctx, 0, nodes);
+        initializeElementRange(ctx, 0, elements);
+    }
+}
+
+// Initial conditions of nodes [start, end) in buffer 0, with their partials
+void initializeNodeRange(luleshCtx *ctx, int start, int end) {
+    for (int node_id = start; node_id < end; node_id++) {
         allNodeData[0][node_id].force = ctx->domain.initial_force[node_id];
         allNodeData[0][node_id].position = ctx->domain.initial_position[node_id];
         allNodeData[0][node_id].velocity = ctx->domain.initial_velocity[node_id];
     }
-    
-    for (int element_id = 0; element_id < elements; element_id++) {
+
+    for (int i = start * 8; i < end * 8; i++) {
+        allPartialData[0][i].stress = vector_new(0.0, 0.0, 0.0);
+        allPartialData[0][i].hourglass = vector_new(0.0, 0.0, 0.0);
+    }
+}
+
+// Initial conditions of elements [start, end) in buffer 0, with their gradients
+void initializeElementRange(luleshCtx *ctx, int start, int end) {
+    for (int element_id = start; element_id < end; element_id++) {
         allElementData[0][element_id].volume = ctx->domain.initial_volume[element_id];
         allElementData[0][element_id].volume_derivative = 0.0;
         allElementData[0][element_id].v_relative = 1.0;
@@ -322,30 +404,46 @@ void initializeAllDataBlocks(luleshCtx *ctx) {
         allElementData[0][element_id].dthydro = 1.0e+20;
     }
     
-    for (int element_id = 0; element_id < elements; element_id++) {
+    for (int element_id = start; element_id < end; element_id++) {
         memset(&allGradientData[0][element_id], 0, sizeof(GradientData));
     }
-    
-    for (int i = 0; i < partials; i++) {
-        allPartialData[0][i].stress = vector_new(0.0, 0.0, 0.0);
-        allPartialData[0][i].hourglass = vector_new(0.0, 0.0, 0.0);
-    }
-    
-    timingData[0]->dt = ctx->domain.initial_delta_time;
-    timingData[0]->elapsed = 0.0;
 }
 
 /*============================================================================
- * Spawn Fused EDTs for One Iteration (Only 5 Phases!)
+ * Iteration Graph Template (Only 5 Phases!)
  *============================================================================*/
 
-void startIteration(int iteration, luleshCtx *ctx) {
+void captureIterationGraph(IterationGraph *graph) {
+    int elements = globalCtx->elements;
+    int nodes = globalCtx->nodes;
+
+    memset(graph, 0, sizeof(IterationGraph));
+
+    // Phase 1: Compute partials (stress + hourglass) - element based
+    int phase1 = graphAddPhase(graph, "partials", computePartialsTiledEdt, NULL, elements, 0, NULL);
+
+    // Phase 2: Force reduction + Velocity + Position - node based
+    int phase2 = graphAddPhase(graph, "kinematics", reduceAndKinematicsTiledEdt, NULL, nodes, 1, &phase1);
+
+    // Phase 3: Volume + VolDeriv + Gradients + CharLen - element based
+    int phase3 = graphAddPhase(graph, "volume", volumeAndDerivedTiledEdt, NULL, elements, 1, &phase2);
+
+    // Phase 4: Viscosity + Energy + TimeConstraints - element based
+    // Phase 5 (computeDeltaTimeEdt) is attached to the sink phase
+    graphAddPhase(graph, "energy", energyAndConstraintsTiledEdt, NULL, elements, 1, &phase3);
+}
+
+/*============================================================================
+ * Spawn Fused EDTs for One Iteration
+ *============================================================================*/
+
+void printIterationInfo(int iteration) {
     int prev_buf = (iteration - 1 + 2) % 2;
-    
-    // Print iteration info
+
     if (!g_config.quiet) {
         double delta_time = timingData[prev_buf]->dt;
-        double energy = allElementData[prev_buf][0].energy;
+        int origin_id = globalCtx->mesh.element_lex_map[0];
+        double energy = allElementData[prev_buf][origin_id].energy;
         PRINTF("iteration %d, delta time %f, energy %f\n", iteration, delta_time, energy);
     }
 
@@ -353,50 +451,42 @@ void startIteration(int iteration, luleshCtx *ctx) {
         PRINTF("cycle = %d, time = %e, dt=%e\n", iteration,
                timingData[prev_buf]->elapsed, timingData[prev_buf]->dt);
     }
+}
 
-    int num_elem_tiles = g_config.num_element_tiles;
-    int num_node_tiles = g_config.num_node_tiles;
-    
-    // Phase 1: Compute partials (stress + hourglass) - element based
-    artsGuid_t phase1DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase1DoneEvent};
-        artsEdtCreate(computePartialsTiledEdt, 0, 3, params, 0);
-    }
-    
-    // Phase 2: Force reduction + Velocity + Position - node based
-    artsGuid_t phase2DoneEvent = artsEventCreate(0, num_node_tiles);
-    
-    for (int tile_id = 0; tile_id < num_node_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase2DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(reduceAndKinematicsTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase1DoneEvent, edtGuid, 0);
+void startIteration(int iteration, luleshCtx *ctx) {
+    printIterationInfo(iteration);
+    profileIterationStart();
+
+    // Auto-tuning swaps tile sizes between iterations and recaptures
+    tuneBeginIteration();
+
+    if (g_graph.num_phases == 0) {
+        uint64_t t0 = artsGetTimeStamp();
+        captureIterationGraph(&g_graph);
+        g_launch.capture_ns += artsGetTimeStamp() - t0;
     }
-    
-    // Phase 3: Volume + VolDeriv + Gradients + CharLen - element based
-    artsGuid_t phase3DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase3DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(volumeAndDerivedTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase2DoneEvent, edtGuid, 0);
+
+    if (tuneTiming()) {
+        instantiateTimedIteration(iteration);
+        return;
     }
-    
-    // Phase 4: Viscosity + Energy + TimeConstraints - element based
-    artsGuid_t phase4DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase4DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(energyAndConstraintsTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase3DoneEvent, edtGuid, 0);
+
+    if (!g_config.replay_graph || tuneActive()) {
+        instantiateIterationGraph(&g_graph, iteration, NULL_GUID, NULL_GUID);
+        return;
     }
-    
-    // Phase 5: Delta time computation (single task)
-    {
-        uint64_t params[1] = {iteration};
-        artsGuid_t edtGuid = artsEdtCreate(computeDeltaTimeEdt, 0, 1, params, 1);
-        artsAddDependence(phase4DoneEvent, edtGuid, 0);
+
+    // Replay: build this iteration directly and start instantiating the
+    // next one in the background, gated on the event this one releases
+    artsGuid_t nextStartEvent = NULL_GUID;
+    if (iteration < g_config.max_iterations)
+        nextStartEvent = artsEventCreate(0, 1);
+
+    instantiateIterationGraph(&g_graph, iteration, NULL_GUID, nextStartEvent);
+
+    if (nextStartEvent != NULL_GUID) {
+        uint64_t params[2] = {iteration + 1, (uint64_t)nextStartEvent};
+        artsEdtCreate(instantiateIterationEdt, 0, 2, params, 0);
     }
 }
 
@@ -432,11 +522,25 @@ void initPerWorker(unsigned int nodeId, unsigned int workerId, int argc, char **
         
         // Initialize ALL data blocks ONCE (DB Reuse!)
         initializeAllDataBlocks(globalCtx);
-        
-        startIteration(1, globalCtx);
+
+        // With -N the simulation starts once the initialization tiles finish
+        if (g_config.first_touch)
+            firstTouchInitialize(globalCtx);
+        else
+            beginSimulation(globalCtx);
     }
 }
 
+void beginSimulation(luleshCtx *ctx) {
+    // Resume after the checkpointed iteration when restarting
+    int first_iteration = 1;
+    if (g_config.restart_file)
+        first_iteration = restartFromCheckpoint(ctx) + 1;
+
+    profileInit();
+    startIteration(first_iteration, ctx);
+}
+
 /*============================================================================
  * Main Entry Point
  *============================================================================*/
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * LULESH Optimized - NUMA First-Touch Initialization (-N)
+ *
+ * Linux places a page on the NUMA node of the thread that first writes it.
+ * By default the setup EDT writes all of buffer 0's initial conditions, so
+ * on a multi-socket machine every page of the pinned node/element/gradient/
+ * partial DBs sits on one socket, and the other sockets' workers run
+ * against remote memory for the whole simulation. Buffer 1 is already
+ * first written by the iteration 1 tiles.
+ *
+ * With -N, buffer 0 is filled by firstTouchTileEdt. Each array is touched
+ * in the tiles of the first phase that works through it (kinematics for the
+ * nodes and their partials, partials for the elements and gradients), with
+ * that phase's -T size, so the pages end up spread over the sockets in
+ * tile-sized pieces. Sizes chosen later by -A are not known yet; the warm-up
+ * iteration runs at the same sizes. ARTS gives a tile no fixed
+ * worker, so a tile is not guaranteed to run next to its pages later;
+ * the gain is that bandwidth now comes from every socket.
+ *
+ * printMemoryPlacement reports the node of every page of the data blocks
+ * (move_pages query mode), so runs with and without -N can be compared.
+ ******************************************************************************/
+// syscall is a GNU extension, not C17
+#define _GNU_SOURCE
+#include "lulesh.h"
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define PLACEMENT_MAX_NODES 64
+#define PLACEMENT_BATCH 1024
+
+// Phase ids, in the order captureIterationGraph adds the phases
+#define PARTIALS_PHASE 0
+#define KINEMATICS_PHASE 1
+
+/*============================================================================
+ * Tiled Initialization
+ *============================================================================*/
+
+void firstTouchTileEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int tile_id = (int)paramv[0];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[1];
+    int node_tile_size = (int)paramv[2];
+    int element_tile_size = (int)paramv[3];
+
+    luleshCtx *ctx = globalCtx;
+    int start, end;
+
+    // Past the end of either array the range is empty
+    getTileRange(tile_id, ctx->nodes, node_tile_size, &start, &end);
+    initializeNodeRange(ctx, start, end);
+
+    getTileRange(tile_id, ctx->elements, element_tile_size, &start, &end);
+    initializeElementRange(ctx, start, end);
+
+    artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
+}
+
+void beginSimulationEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    beginSimulation(globalCtx);
+}
+
+void firstTouchInitialize(luleshCtx *ctx) {
+    int node_tile_size = phaseTileSize(KINEMATICS_PHASE);
+    int element_tile_size = phaseTileSize(PARTIALS_PHASE);
+    int num_node_tiles = (ctx->nodes + node_tile_size - 1) / node_tile_size;
+    int num_element_tiles = (ctx->elements + element_tile_size - 1) / element_tile_size;
+    int num_tiles = num_node_tiles > num_element_tiles ? num_node_tiles : num_element_tiles;
+
+    artsGuid_t doneEvent = artsEventCreate(0, num_tiles);
+    artsGuid_t startGuid = artsEdtCreate(beginSimulationEdt, 0, 0, NULL, 1);
+    artsAddDependence(doneEvent, startGuid, 0);
+
+    for (int tile_id = 0; tile_id < num_tiles; tile_id++) {
+        uint64_t params[4] = {tile_id, (uint64_t)doneEvent, node_tile_size, element_tile_size};
+        artsEdtCreate(firstTouchTileEdt, 0, 4, params, 0);
+    }
+}
+
+/*============================================================================
+ * Page Placement Report
+ *============================================================================*/
+
+typedef struct PagePlacement {
+    uint64_t pages[PLACEMENT_MAX_NODES];
+    uint64_t absent;                // Not yet touched, or not queryable
+    int max_node;
+} PagePlacement;
+
+// Returns 0 if the kernel does not support the query
+static int countPages(PagePlacement *placement, const void *addr, size_t bytes) {
+#ifdef SYS_move_pages
+    long page_size = sysconf(_SC_PAGESIZE);
+    uintptr_t first = (uintptr_t)addr & ~(uintptr_t)(page_size - 1);
+    uintptr_t last = (uintptr_t)addr + bytes;
+    void *pages[PLACEMENT_BATCH];
+    int status[PLACEMENT_BATCH];
+
+    for (uintptr_t page = first; page < last;) {
+        unsigned long count = 0;
+        for (; count < PLACEMENT_BATCH && page < last; count++, page += page_size)
+            pages[count] = (void *)page;
+
+        // nodes == NULL only queries; status[i] is the node or -errno
+        if (syscall(SYS_move_pages, 0, count, pages, NULL, status, 0) != 0)
+            return 0;
+
+        for (unsigned long i = 0; i < count; i++) {
+            if (status[i] >= 0 && status[i] < PLACEMENT_MAX_NODES) {
+                placement->pages[status[i]]++;
+                if (status[i] > placement->max_node)
+                    placement->max_node = status[i];
+            } else {
+                placement->absent++;
+            }
+        }
+    }
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+void printMemoryPlacement(luleshCtx *ctx) {
+    PagePlacement placement = {0};
+    int ok = 1;
+
+    for (int buf = 0; buf < 2 && ok; buf++) {
+        ok = countPages(&placement, allNodeData[buf], sizeof(NodeData) * ctx->nodes) &&
+             countPages(&placement, allElementData[buf], sizeof(ElementData) * ctx->elements) &&
+             countPages(&placement, allGradientData[buf], sizeof(GradientData) * ctx->elements) &&
+             countPages(&placement, allPartialData[buf], sizeof(PartialData) * ctx->nodes * 8);
+    }
+
+    // Single-node machines have nothing to report unless -N asked for it
+    if (!g_config.first_touch && (!ok || placement.max_node == 0))
+        return;
+
+    const char *init = g_config.first_touch ? "first-touch tiles" : "serial init";
+    if (!ok) {
+        PRINTF("Memory placement     = unavailable (move_pages query failed; %s)\n\n", init);
+        return;
+    }
+
+    uint64_t total = placement.absent;
+    for (int node = 0; node <= placement.max_node; node++)
+        total += placement.pages[node];
+
+    char nodes[256];
+    size_t used = 0;
+    nodes[0] = '\0';
+    for (int node = 0; node <= placement.max_node && used < sizeof(nodes); node++) {
+        used += snprintf(nodes + used, sizeof(nodes) - used, "%snode%d %.1f%%", node ? ", " : "",
+                         node, total ? 100.0 * placement.pages[node] / total : 0.0);
+    }
+
+    PRINTF("Memory placement     = %s of %lu pages%s (%s)\n\n", nodes, (unsigned long)total,
+           placement.absent ? ", some not resident" : "", init);
+}
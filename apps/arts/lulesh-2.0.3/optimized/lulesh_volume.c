@@ -265,13 +265,16 @@ void volumeAndDerivedTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc,
     int iteration = (int)paramv[0];
     int tile_id = (int)paramv[1];
     artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int tile_size = (int)paramv[3];
+    int phase_id = (int)paramv[4];
+    uint64_t t0 = profileTileBegin();
     
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
     double dt = timingData[prev_buf]->dt;
     
     int start, end;
-    getTileRange(tile_id, ctx->elements, g_config.tile_size, &start, &end);
+    getTileRange(tile_id, ctx->elements, tile_size, &start, &end);
     
     for (int element_id = start; element_id < end; element_id++) {
         // Fused: Volume first, then all derived computations
@@ -281,5 +284,6 @@ void volumeAndDerivedTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc,
         computeCharacteristicLengthForElement(iteration, element_id, ctx);
     }
     
+    profileTileEnd(phase_id, t0);
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
 }
@@ -32,7 +32,12 @@
 #define DEFAULT_EDGE_ELEMENTS 30
 #endif
 
-// Precision for cbrt approximation
+// Default elements/nodes per EDT (-g overrides it); 1 is one EDT per item
+#ifndef GRAIN_SIZE
+#define GRAIN_SIZE 1
+#endif
+
+// Precision for the Newton cube root (-DLULESH_NEWTON_CBRT)
 #define PRECISION 1.0e-10
 
 /*============================================================================
@@ -40,16 +45,56 @@
  *============================================================================*/
 
 typedef struct RuntimeConfig {
-    int edge_elements;      // -s <size>: problem size (elements per edge)
-    int max_iterations;     // -i <iter>: maximum iterations
-    double stop_time;       // -t <time>: stop time
-    int show_progress;      // -p: show iteration progress
-    int quiet;              // -q: quiet mode (minimal output)
-    uint64_t start_time;    // Start time in nanoseconds (for timing)
+    int edge_elements;              // -s <size>: problem size (elements per edge)
+    int max_iterations;             // -i <iter>: maximum iterations
+    double stop_time;               // -t <time>: stop time
+    int show_progress;              // -p: show iteration progress
+    int quiet;                      // -q: quiet mode (minimal output)
+    uint64_t start_time;            // Start time in nanoseconds (for timing)
+    int grain_size;                 // -g <n>: elements/nodes handled by one EDT
+    int profile;                    // -P: per-phase/per-task timing report at shutdown
+    int checkpoint_interval;        // -C <n>: checkpoint every n iterations (0 = off)
+    const char *checkpoint_file;    // -F <file>: checkpoint path
+    const char *restart_file;       // -restart <file>: resume from a checkpoint
+    int restart_iteration;          // Iteration restored on restart (0 otherwise)
 } RuntimeConfig;
 
 extern RuntimeConfig g_config;
 
+/*============================================================================
+ * Phase Profiling (-P)
+ *
+ * The phases are the ones startIteration separates with latch events; each
+ * per-element/per-node EDT counts as one tile of its phase. Timestamps go to
+ * the running worker's own buffer and are folded by computeDeltaTimeEdt.
+ *============================================================================*/
+
+typedef enum LuleshPhase {
+    PHASE_PARTIALS = 0,             // Stress + hourglass (phase 1)
+    PHASE_REDUCE_FORCE,
+    PHASE_VELOCITY,
+    PHASE_POSITION,
+    PHASE_VOLUME,
+    PHASE_VOLUME_DERIVATIVE,
+    PHASE_GRADIENTS,
+    PHASE_VISCOSITY,
+    PHASE_ENERGY,
+    PHASE_CHARACTERISTIC_LENGTH,
+    PHASE_TIME_CONSTRAINTS,
+    NUM_PHASES
+} LuleshPhase;
+
+void profileRecordTile(int phase_id, uint64_t start_ns);
+
+static inline uint64_t profileTileBegin(void) {
+    return g_config.profile ? artsGetTimeStamp() : 0;
+}
+
+static inline void profileTileEnd(int phase_id, uint64_t start_ns) {
+    if (start_ns)
+        profileRecordTile(phase_id, start_ns);
+}
+
 /*============================================================================
  * Basic Types
  *============================================================================*/
@@ -220,18 +265,8 @@ static inline vector cross(vector a, vector b) {
                     a.x * b.y - a.y * b.x};
 }
 
-// Cube root using Newton's method (for TG compatibility)
-static inline double my_cbrt(double x) {
-    if (x == 0.0) return 0.0;
-    double ans = 1.0, old = 0.0;
-    int iter = 0;
-    while (fabs(old - ans) >= PRECISION && iter < 100) {
-        old = ans;
-        ans = (x / (ans * ans) + 2.0 * ans) / 3.0;
-        iter++;
-    }
-    return ans;
-}
+// Cube root shared by all variants (see common/lulesh_cbrt.h)
+#include "lulesh_cbrt.h"
 
 /*============================================================================
  * GUID Index Calculation Helpers
@@ -281,5 +316,20 @@ void initGraphContext(luleshCtx *ctx);
 void startIteration(int iteration, luleshCtx *ctx);
 void parseCommandLine(int argc, char **argv);
 void printUsage(const char *progname);
+int grainTasks(int num_items);
+int iterationTasks(luleshCtx *ctx);
+
+// Phase profiling
+void profileInit(void);
+void profileIterationStart(void);
+void profileEndIteration(uint64_t start_ns);
+void printPhaseProfile(double elapsed_wall_time);
+
+// Checkpoint/restart
+void checkpointIteration(int iteration, luleshCtx *ctx);
+void checkpointWriteEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+int checkpointDeferShutdown(void);
+int restartFromCheckpoint(luleshCtx *ctx);
+void printCheckpointStatistics(int iterations);
 
 #endif /* LULESH_ARTS_H */
@@ -21,11 +21,7 @@ static inline double areaFace(vertex a, vertex b, vertex c, vertex d) {
     return area;
 }
 
-void computeCharacteristicLengthEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int element_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeCharacteristicLengthElement(int iteration, int element_id) {
     luleshCtx *ctx = globalCtx;
     int curr_buf = iteration % 2;
     
@@ -73,6 +69,20 @@ void computeCharacteristicLengthEdt(uint32_t paramc, uint64_t *paramv, uint32_t
     
     // Store characteristic length
     elementDataPtrs[curr_buf][element_id]->characteristic_length = charLength;
+}
+
+void computeCharacteristicLengthEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_element = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_element = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Elements [first_element, last_element) of this grain
+    for (int element_id = first_element; element_id < last_element; element_id++)
+        computeCharacteristicLengthElement(iteration, element_id);
+    
+    profileTileEnd(PHASE_CHARACTERISTIC_LENGTH, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
@@ -24,8 +24,10 @@ static void printFinalStatistics(int iteration, double elapsed_sim_time,
       (double)(end_time - g_config.start_time) / 1.0e9; // Convert ns to seconds
 
   // Grind time calculation (same as baseline)
+  // Only the iterations run by this process count after a restart
+  int cycles = iteration - g_config.restart_iteration;
   double grindTime1 =
-      ((elapsed_wall_time * 1.0e6) / iteration) / (nx * nx * nx);
+      ((elapsed_wall_time * 1.0e6) / cycles) / (nx * nx * nx);
   double grindTime2 = grindTime1; // Same since single process
 
   // Get final origin energy
@@ -69,11 +71,17 @@ static void printFinalStatistics(int iteration, double elapsed_sim_time,
   PRINTF("\nElapsed time         = %10.2f (s)\n", elapsed_wall_time);
   PRINTF("Grind time (us/z/c)  = %10.8g (per dom)  (%10.8g overall)\n",
          grindTime1, grindTime2);
-  PRINTF("FOM                  = %10.8g (z/s)\n\n", 1000.0 / grindTime2);
+  PRINTF("FOM                  = %10.8g (z/s)\n", 1000.0 / grindTime2);
+  PRINTF("Grain size           = %10d (items/EDT)  %d EDTs per iteration\n\n",
+         g_config.grain_size, iterationTasks(ctx));
+
+  printPhaseProfile(elapsed_wall_time);
+  printCheckpointStatistics(cycles);
 }
 
 void computeDeltaTimeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
     int iteration = (int)paramv[0];
+    uint64_t t0 = profileTileBegin();
     
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
@@ -145,13 +153,17 @@ void computeDeltaTimeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsE
     timingDataPtrs[curr_buf]->dt = delta_time;
     timingDataPtrs[curr_buf]->elapsed = elapsed_time;
     
+    profileEndIteration(t0);
+    checkpointIteration(iteration, ctx);
+    
     // Check termination condition
     int maxiter = ctx->constraints.maximum_iterations;
     if (iteration >= maxiter || elapsed_time >= stop_time) {
       // Print final statistics in baseline format
       printFinalStatistics(iteration, elapsed_time, delta_time, ctx);
 
-      artsShutdown();
+      if (!checkpointDeferShutdown())
+        artsShutdown();
     } else {
         // Start next iteration
         startIteration(iteration + 1, ctx);
@@ -10,11 +10,7 @@ extern artsGuid_t timingDataGuids[2];
 extern TimingData *timingDataPtrs[2];
 extern luleshCtx *globalCtx;
 
-void computeEnergyEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int element_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeEnergyElement(int iteration, int element_id) {
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
     int curr_buf = iteration % 2;
@@ -163,6 +159,20 @@ void computeEnergyEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtD
     elementDataPtrs[curr_buf][element_id]->pressure = pressure;
     elementDataPtrs[curr_buf][element_id]->viscosity = viscosity;
     elementDataPtrs[curr_buf][element_id]->sound_speed = sound_speed;
+}
+
+void computeEnergyEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_element = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_element = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Elements [first_element, last_element) of this grain
+    for (int element_id = first_element; element_id < last_element; element_id++)
+        computeEnergyElement(iteration, element_id);
+    
+    profileTileEnd(PHASE_ENERGY, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
@@ -12,11 +12,7 @@ extern artsGuid_t gradientDataGuids[2][MAX_ELEMENTS];
 extern GradientData *gradientDataPtrs[2][MAX_ELEMENTS];
 extern luleshCtx *globalCtx;
 
-void computeGradientsEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int element_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeGradientsElement(int iteration, int element_id) {
     luleshCtx *ctx = globalCtx;
     int curr_buf = iteration % 2;
     
@@ -115,7 +111,21 @@ void computeGradientsEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsE
         position_gradient;
     gradientDataPtrs[curr_buf][element_id]->velocity_gradient =
         velocity_gradient;
+}
 
+void computeGradientsEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_element = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_element = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Elements [first_element, last_element) of this grain
+    for (int element_id = first_element; element_id < last_element; element_id++)
+        computeGradientsElement(iteration, element_id);
+
+    profileTileEnd(PHASE_GRADIENTS, t0);
+    
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
 }
@@ -11,11 +11,7 @@ extern artsGuid_t hourglassPartialGuids[2][MAX_NODES * 8];
 extern vector *hourglassPartialPtrs[2][MAX_NODES * 8];
 extern luleshCtx *globalCtx;
 
-void computeHourglassPartialEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int element_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeHourglassPartialElement(int iteration, int element_id) {
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
     int curr_buf = iteration % 2;
@@ -145,6 +141,20 @@ void computeHourglassPartialEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc
             }
         }
     }
+}
+
+void computeHourglassPartialEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_element = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_element = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Elements [first_element, last_element) of this grain
+    for (int element_id = first_element; element_id < last_element; element_id++)
+        computeHourglassPartialElement(iteration, element_id);
+    
+    profileTileEnd(PHASE_PARTIALS, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
@@ -10,11 +10,7 @@ extern artsGuid_t timingDataGuids[2];
 extern TimingData *timingDataPtrs[2];
 extern luleshCtx *globalCtx;
 
-void computeTimeConstraintsEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int element_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeTimeConstraintsElement(int iteration, int element_id) {
     luleshCtx *ctx = globalCtx;
     int curr_buf = iteration % 2;
     
@@ -54,6 +50,20 @@ void computeTimeConstraintsEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc,
     // Store time constraints in element data
     elementDataPtrs[curr_buf][element_id]->dtcourant = dtcourant;
     elementDataPtrs[curr_buf][element_id]->dthydro = dthydro;
+}
+
+void computeTimeConstraintsEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_element = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_element = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Elements [first_element, last_element) of this grain
+    for (int element_id = first_element; element_id < last_element; element_id++)
+        computeTimeConstraintsElement(iteration, element_id);
+    
+    profileTileEnd(PHASE_TIME_CONSTRAINTS, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
@@ -9,11 +9,7 @@ extern artsGuid_t timingDataGuids[2];
 extern TimingData *timingDataPtrs[2];
 extern luleshCtx *globalCtx;
 
-void computeVelocityEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int node_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeVelocityNode(int iteration, int node_id) {
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
     int curr_buf = iteration % 2;
@@ -46,6 +42,20 @@ void computeVelocityEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEd
     
     // Store new velocity
     nodeDataPtrs[curr_buf][node_id]->velocity = new_velocity;
+}
+
+void computeVelocityEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_node = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_node = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Nodes [first_node, last_node) of this grain
+    for (int node_id = first_node; node_id < last_node; node_id++)
+        computeVelocityNode(iteration, node_id);
+    
+    profileTileEnd(PHASE_VELOCITY, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
@@ -9,11 +9,7 @@ extern artsGuid_t elementDataGuids[2][MAX_ELEMENTS];
 extern ElementData *elementDataPtrs[2][MAX_ELEMENTS];
 extern luleshCtx *globalCtx;
 
-void computeVolumeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int element_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeVolumeElement(int iteration, int element_id) {
     luleshCtx *ctx = globalCtx;
     int curr_buf = iteration % 2;
     
@@ -55,6 +51,20 @@ void computeVolumeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtD
     
     // Store relative volume in element data
     elementDataPtrs[curr_buf][element_id]->volume = volume_out;
+}
+
+void computeVolumeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_element = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_element = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Elements [first_element, last_element) of this grain
+    for (int element_id = first_element; element_id < last_element; element_id++)
+        computeVolumeElement(iteration, element_id);
+    
+    profileTileEnd(PHASE_VOLUME, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
@@ -11,11 +11,7 @@ extern artsGuid_t timingDataGuids[2];
 extern TimingData *timingDataPtrs[2];
 extern luleshCtx *globalCtx;
 
-void computeVolumeDerivativeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int element_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void computeVolumeDerivativeElement(int iteration, int element_id) {
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
     int curr_buf = iteration % 2;
@@ -95,6 +91,20 @@ void computeVolumeDerivativeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc
     // Store in element data
     elementDataPtrs[curr_buf][element_id]->v_relative = v_relative;
     elementDataPtrs[curr_buf][element_id]->volume_derivative = volume_derivative;
+}
+
+void computeVolumeDerivativeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_element = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_element = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Elements [first_element, last_element) of this grain
+    for (int element_id = first_element; element_id < last_element; element_id++)
+        computeVolumeDerivativeElement(iteration, element_id);
+    
+    profileTileEnd(PHASE_VOLUME_DERIVATIVE, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
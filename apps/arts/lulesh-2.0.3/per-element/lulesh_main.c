@@ -19,7 +19,13 @@ RuntimeConfig g_config = {.edge_elements = DEFAULT_EDGE_ELEMENTS,
                           .show_progress =
                               0, // Default off like baseline (use -p to enable)
                           .quiet = 0,
-                          .start_time = 0};
+                          .start_time = 0,
+                          .grain_size = GRAIN_SIZE,
+                          .profile = 0,
+                          .checkpoint_interval = 0,
+                          .checkpoint_file = "lulesh.ckpt",
+                          .restart_file = NULL,
+                          .restart_iteration = 0};
 
 // Per-node arrays (iteration 0 and 1, double buffered)
 artsGuid_t nodeDataGuids[2][MAX_NODES];
@@ -57,18 +63,29 @@ void printUsage(const char *progname) {
       DEFAULT_EDGE_ELEMENTS, MAX_EDGE_ELEMENTS);
   printf("  -i <iter>    Maximum iterations (default: 9999999)\n");
   printf("  -t <time>    Stop time (default: 1.0e-2)\n");
+  printf("  -g <n>       Elements/nodes per EDT (default: %d)\n", GRAIN_SIZE);
+  printf("  -P           Report per-phase/per-task timing at shutdown\n");
+  printf("  -C <n>       Checkpoint every n iterations (default: off)\n");
+  printf("  -F <file>    Checkpoint file (default: lulesh.ckpt)\n");
+  printf("  -restart <file>  Resume from a checkpoint (same -s)\n");
   printf("  -p           Show iteration progress (default: on)\n");
   printf("  -q           Quiet mode (minimal output)\n");
   printf("  -h           Show this help message\n");
 }
 
+static const struct option long_options[] = {
+    {"restart", required_argument, NULL, 'X'},
+    {NULL, 0, NULL, 0}
+};
+
 void parseCommandLine(int argc, char **argv) {
     int opt;
     
     // Reset optind for ARTS which may have parsed its own args
     optind = 1;
     
-    while ((opt = getopt(argc, argv, "s:i:t:pqh")) != -1) {
+    // getopt_long_only so that -restart works with a single dash
+    while ((opt = getopt_long_only(argc, argv, "s:i:t:g:PC:F:pqh", long_options, NULL)) != -1) {
         switch (opt) {
             case 's':
                 g_config.edge_elements = atoi(optarg);
@@ -98,6 +115,29 @@ void parseCommandLine(int argc, char **argv) {
                   g_config.stop_time = 1.0e-2;
                 }
                 break;
+            case 'g':
+                g_config.grain_size = atoi(optarg);
+                if (g_config.grain_size < 1) {
+                  fprintf(stderr, "Error: grain size must be at least 1\n");
+                  g_config.grain_size = GRAIN_SIZE;
+                }
+                break;
+            case 'P':
+                g_config.profile = 1;
+                break;
+            case 'C':
+                g_config.checkpoint_interval = atoi(optarg);
+                if (g_config.checkpoint_interval < 0) {
+                  fprintf(stderr, "Error: checkpoint interval must be non-negative\n");
+                  g_config.checkpoint_interval = 0;
+                }
+                break;
+            case 'F':
+                g_config.checkpoint_file = optarg;
+                break;
+            case 'X':
+                g_config.restart_file = optarg;
+                break;
             case 'p':
                 g_config.show_progress = 1;
                 break;
@@ -402,6 +442,35 @@ void allocateIterationData(int iteration, luleshCtx *ctx) {
  * Spawn EDTs for One Iteration
  *============================================================================*/
 
+// Number of EDTs a phase over num_items elements/nodes is split into
+int grainTasks(int num_items) {
+    return (num_items + g_config.grain_size - 1) / g_config.grain_size;
+}
+
+// EDTs spawned per iteration: 11 phases (phase 1 spawns two EDTs per grain),
+// plus computeDeltaTimeEdt
+int iterationTasks(luleshCtx *ctx) {
+    return 9 * grainTasks(ctx->elements) + 3 * grainTasks(ctx->nodes) + 1;
+}
+
+// Spawns one EDT per grain of -g consecutive items; each gets
+// {iteration, first item, doneEvent, last item + 1} and waits on readyEvent
+static void spawnPhase(artsEdt_t edt, int iteration, int num_items,
+                       artsGuid_t readyEvent, artsGuid_t doneEvent) {
+    for (int first = 0; first < num_items; first += g_config.grain_size) {
+        int last = first + g_config.grain_size;
+        if (last > num_items)
+            last = num_items;
+        uint64_t params[4] = {iteration, first, (uint64_t)doneEvent, last};
+        if (readyEvent == NULL_GUID) {
+            artsEdtCreate(edt, 0, 4, params, 0);
+        } else {
+            artsGuid_t edtGuid = artsEdtCreate(edt, 0, 4, params, 1);
+            artsAddDependence(readyEvent, edtGuid, 0);
+        }
+    }
+}
+
 // External references for iteration data
 extern artsGuid_t elementDataGuids[2][MAX_ELEMENTS];
 extern ElementData *elementDataPtrs[2][MAX_ELEMENTS];
@@ -409,6 +478,8 @@ extern artsGuid_t timingDataGuids[2];
 extern TimingData *timingDataPtrs[2];
 
 void startIteration(int iteration, luleshCtx *ctx) {
+  profileIterationStart();
+
   // Print iteration info in baseline format: "iteration N, delta time X, energy
   // Y" Use data from the previous iteration (which just completed)
   if (!g_config.quiet) {
@@ -430,67 +501,33 @@ void startIteration(int iteration, luleshCtx *ctx) {
     allocateIterationData(iteration, ctx);
     
     // Phase 1: Stress and Hourglass partials (parallel per element)
-    artsGuid_t phase1DoneEvent = artsEventCreate(0, ctx->elements * 2);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase1DoneEvent};
-        artsEdtCreate(computeStressPartialEdt, 0, 3, params, 0);
-        artsEdtCreate(computeHourglassPartialEdt, 0, 3, params, 0);
-    }
+    artsGuid_t phase1DoneEvent = artsEventCreate(0, grainTasks(ctx->elements) * 2);
+    spawnPhase(computeStressPartialEdt, iteration, ctx->elements, NULL_GUID, phase1DoneEvent);
+    spawnPhase(computeHourglassPartialEdt, iteration, ctx->elements, NULL_GUID, phase1DoneEvent);
     
     // Phase 2: Reduce force (after phase 1, parallel per node)
-    artsGuid_t phase2DoneEvent = artsEventCreate(0, ctx->nodes);
-    
-    for (int node_id = 0; node_id < ctx->nodes; node_id++) {
-        uint64_t params[3] = {iteration, node_id, (uint64_t)phase2DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(reduceForceEdt, 0, 3, params, 1);
-        artsAddDependence(phase1DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase2DoneEvent = artsEventCreate(0, grainTasks(ctx->nodes));
+    spawnPhase(reduceForceEdt, iteration, ctx->nodes, phase1DoneEvent, phase2DoneEvent);
     
     // Phase 3: Velocity computation (after phase 2, parallel per node)
-    artsGuid_t phase3DoneEvent = artsEventCreate(0, ctx->nodes);
-    
-    for (int node_id = 0; node_id < ctx->nodes; node_id++) {
-        uint64_t params[3] = {iteration, node_id, (uint64_t)phase3DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeVelocityEdt, 0, 3, params, 1);
-        artsAddDependence(phase2DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase3DoneEvent = artsEventCreate(0, grainTasks(ctx->nodes));
+    spawnPhase(computeVelocityEdt, iteration, ctx->nodes, phase2DoneEvent, phase3DoneEvent);
     
     // Phase 4: Position computation (after phase 3, parallel per node)
-    artsGuid_t phase4DoneEvent = artsEventCreate(0, ctx->nodes);
-    
-    for (int node_id = 0; node_id < ctx->nodes; node_id++) {
-        uint64_t params[3] = {iteration, node_id, (uint64_t)phase4DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computePositionEdt, 0, 3, params, 1);
-        artsAddDependence(phase3DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase4DoneEvent = artsEventCreate(0, grainTasks(ctx->nodes));
+    spawnPhase(computePositionEdt, iteration, ctx->nodes, phase3DoneEvent, phase4DoneEvent);
     
     // Phase 5: Volume computation (after phase 4, parallel per element)
-    artsGuid_t phase5DoneEvent = artsEventCreate(0, ctx->elements);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase5DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeVolumeEdt, 0, 3, params, 1);
-        artsAddDependence(phase4DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase5DoneEvent = artsEventCreate(0, grainTasks(ctx->elements));
+    spawnPhase(computeVolumeEdt, iteration, ctx->elements, phase4DoneEvent, phase5DoneEvent);
     
     // Phase 6: Volume derivative computation (after phase 5, parallel per element)
-    artsGuid_t phase6DoneEvent = artsEventCreate(0, ctx->elements);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase6DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeVolumeDerivativeEdt, 0, 3, params, 1);
-        artsAddDependence(phase5DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase6DoneEvent = artsEventCreate(0, grainTasks(ctx->elements));
+    spawnPhase(computeVolumeDerivativeEdt, iteration, ctx->elements, phase5DoneEvent, phase6DoneEvent);
     
     // Phase 7: Gradients computation (after phase 5, parallel per element)
-    artsGuid_t phase7DoneEvent = artsEventCreate(0, ctx->elements);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase7DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeGradientsEdt, 0, 3, params, 1);
-        artsAddDependence(phase5DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase7DoneEvent = artsEventCreate(0, grainTasks(ctx->elements));
+    spawnPhase(computeGradientsEdt, iteration, ctx->elements, phase5DoneEvent, phase7DoneEvent);
     
     // Combined event for phases 6 and 7
     artsGuid_t phase67DoneEvent = artsEventCreate(0, 2);
@@ -498,31 +535,16 @@ void startIteration(int iteration, luleshCtx *ctx) {
     artsAddDependence(phase7DoneEvent, phase67DoneEvent, ARTS_EVENT_LATCH_DECR_SLOT);
     
     // Phase 8: Viscosity terms (after phases 6 and 7, parallel per element)
-    artsGuid_t phase8DoneEvent = artsEventCreate(0, ctx->elements);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase8DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeViscosityTermsEdt, 0, 3, params, 1);
-        artsAddDependence(phase67DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase8DoneEvent = artsEventCreate(0, grainTasks(ctx->elements));
+    spawnPhase(computeViscosityTermsEdt, iteration, ctx->elements, phase67DoneEvent, phase8DoneEvent);
     
     // Phase 9: Energy computation (after phase 8, parallel per element)
-    artsGuid_t phase9DoneEvent = artsEventCreate(0, ctx->elements);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase9DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeEnergyEdt, 0, 3, params, 1);
-        artsAddDependence(phase8DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase9DoneEvent = artsEventCreate(0, grainTasks(ctx->elements));
+    spawnPhase(computeEnergyEdt, iteration, ctx->elements, phase8DoneEvent, phase9DoneEvent);
     
     // Phase 10: Characteristic length (after phase 5, parallel per element)
-    artsGuid_t phase10DoneEvent = artsEventCreate(0, ctx->elements);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase10DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeCharacteristicLengthEdt, 0, 3, params, 1);
-        artsAddDependence(phase5DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase10DoneEvent = artsEventCreate(0, grainTasks(ctx->elements));
+    spawnPhase(computeCharacteristicLengthEdt, iteration, ctx->elements, phase5DoneEvent, phase10DoneEvent);
     
     // Combined event for phases 6, 9, and 10
     artsGuid_t phase6910DoneEvent = artsEventCreate(0, 3);
@@ -531,13 +553,8 @@ void startIteration(int iteration, luleshCtx *ctx) {
     artsAddDependence(phase10DoneEvent, phase6910DoneEvent, ARTS_EVENT_LATCH_DECR_SLOT);
     
     // Phase 11: Time constraints (after phases 6, 9, and 10, parallel per element)
-    artsGuid_t phase11DoneEvent = artsEventCreate(0, ctx->elements);
-    
-    for (int element_id = 0; element_id < ctx->elements; element_id++) {
-        uint64_t params[3] = {iteration, element_id, (uint64_t)phase11DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeTimeConstraintsEdt, 0, 3, params, 1);
-        artsAddDependence(phase6910DoneEvent, edtGuid, 0);
-    }
+    artsGuid_t phase11DoneEvent = artsEventCreate(0, grainTasks(ctx->elements));
+    spawnPhase(computeTimeConstraintsEdt, iteration, ctx->elements, phase6910DoneEvent, phase11DoneEvent);
     
     // Phase 12: Delta time computation (after phase 11)
     {
@@ -580,7 +597,13 @@ void initPerWorker(unsigned int nodeId, unsigned int workerId, int argc, char **
         initializeIteration0Data(globalCtx);
         
         // Start first iteration
-        startIteration(1, globalCtx);
+        // Resume after the checkpointed iteration when restarting
+        int first_iteration = 1;
+        if (g_config.restart_file)
+            first_iteration = restartFromCheckpoint(globalCtx) + 1;
+
+        profileInit();
+        startIteration(first_iteration, globalCtx);
     }
 }
 
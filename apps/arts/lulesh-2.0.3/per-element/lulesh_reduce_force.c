@@ -11,11 +11,7 @@ extern artsGuid_t hourglassPartialGuids[2][MAX_NODES * 8];
 extern vector *hourglassPartialPtrs[2][MAX_NODES * 8];
 extern luleshCtx *globalCtx;
 
-void reduceForceEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
-    int iteration = (int)paramv[0];
-    int node_id = (int)paramv[1];
-    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
-    
+static inline void reduceForceNode(int iteration, int node_id) {
     luleshCtx *ctx = globalCtx;
     int curr_buf = iteration % 2;
     
@@ -38,6 +34,20 @@ void reduceForceEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep
     
     // Store reduced force in node data
     nodeDataPtrs[curr_buf][node_id]->force = force_sum;
+}
+
+void reduceForceEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int iteration = (int)paramv[0];
+    int first_node = (int)paramv[1];
+    artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int last_node = (int)paramv[3];
+    uint64_t t0 = profileTileBegin();
+    
+    // Nodes [first_node, last_node) of this grain
+    for (int node_id = first_node; node_id < last_node; node_id++)
+        reduceForceNode(iteration, node_id);
+    
+    profileTileEnd(PHASE_REDUCE_FORCE, t0);
     
     // Signal completion
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
@@ -40,27 +40,134 @@
 #define MAX_ELEMENT_TILES ((MAX_ELEMENTS + TILE_SIZE - 1) / TILE_SIZE)
 #define MAX_NODE_TILES ((MAX_NODES + TILE_SIZE - 1) / TILE_SIZE)
 
-// Precision for cbrt approximation
+// Precision for the Newton cube root (-DLULESH_NEWTON_CBRT)
 #define PRECISION 1.0e-10
 
+// Node/element numbering applied at mesh build time
+typedef enum MeshOrdering {
+    MESH_ORDER_LEXICOGRAPHIC = 0,
+    MESH_ORDER_MORTON,
+    MESH_ORDER_HILBERT
+} MeshOrdering;
+
 /*============================================================================
  * Runtime Configuration (from command line)
  *============================================================================*/
 
 typedef struct RuntimeConfig {
-    int edge_elements;      // -s <size>: problem size (elements per edge)
-    int max_iterations;     // -i <iter>: maximum iterations
-    double stop_time;       // -t <time>: stop time
-    int show_progress;      // -p: show iteration progress
-    int quiet;              // -q: quiet mode (minimal output)
-    uint64_t start_time;    // Start time in nanoseconds (for timing)
-    int tile_size;          // Elements/nodes per tile
-    int num_element_tiles;  // Number of element tiles
-    int num_node_tiles;     // Number of node tiles
+    int edge_elements;              // -s <size>: problem size (elements per edge)
+    int max_iterations;             // -i <iter>: maximum iterations
+    double stop_time;               // -t <time>: stop time
+    int show_progress;              // -p: show iteration progress
+    int quiet;                      // -q: quiet mode (minimal output)
+    uint64_t start_time;            // Start time in nanoseconds (for timing)
+    int tile_size;                  // Elements/nodes per tile
+    int num_element_tiles;          // Number of element tiles
+    int num_node_tiles;             // Number of node tiles
+    int replay_graph;               // -R: capture the iteration graph once and replay it
+    int mesh_ordering;              // -O <order>: node/element numbering (MeshOrdering)
+    int auto_tune;                  // -A: pick per-phase tile sizes from timed iterations
+    int profile;                    // -P: per-phase/per-tile timing report at shutdown
+    int fuse_geometry;              // -f: one phase for volume-deriv/gradients/char-length
+    int checkpoint_interval;        // -C <n>: checkpoint every n iterations (0 = off)
+    const char *checkpoint_file;    // -F <file>: checkpoint path
+    const char *restart_file;       // -restart <file>: resume from a checkpoint
+    int restart_iteration;          // Iteration restored on restart (0 otherwise)
 } RuntimeConfig;
 
 extern RuntimeConfig g_config;
 
+/*============================================================================
+ * Iteration Graph Template (capture once, replay every iteration)
+ *
+ * The 12-phase graph has the same shape on every timestep. It is recorded as
+ * a list of phases; a phase spawns num_edts EDTs per tile that share one done
+ * latch, and a phase with several predecessors waits on a combined latch
+ * (e.g. phases 6+7 before viscosity, 6+9+10 before time constraints).
+ *============================================================================*/
+
+#define MAX_GRAPH_PHASES 16     // Upper bound on phases per iteration
+#define MAX_PHASE_EDTS 2        // EDT functions per tile sharing one latch
+#define MAX_PHASE_DEPS 3        // Predecessor phases joined by one latch
+
+typedef struct GraphPhase {
+    const char *name;               // Label for reports
+    artsEdt_t edts[MAX_PHASE_EDTS]; // EDT functions spawned for every tile
+    int num_edts;                   // Number of valid entries in edts
+    int num_items;                  // Elements or nodes the tiles cover
+    int num_tiles;                  // Element or node tiles
+    int tile_size;                  // Elements/nodes per tile in this phase
+    int num_deps;                   // 0 = released by the iteration start
+    int deps[MAX_PHASE_DEPS];       // Indices of predecessor phases
+} GraphPhase;
+
+typedef struct IterationGraph {
+    int num_phases;                 // Phases recorded in the template
+    int num_latches;                // Latch events created per instantiation
+    int sink_phase;                 // Phase computeDeltaTimeEdt waits on
+    GraphPhase phases[MAX_GRAPH_PHASES];
+} IterationGraph;
+
+typedef struct LaunchStats {
+    uint64_t capture_ns;            // Recording the template
+    uint64_t critical_ns;           // Launch work between two timesteps
+    uint64_t background_ns;         // Replay instantiation overlapped with compute
+    int launches;                   // Iterations launched from computeDeltaTimeEdt
+} LaunchStats;
+
+extern IterationGraph g_graph;
+extern LaunchStats g_launch;
+
+/*============================================================================
+ * Tile-Size Auto-Tuning (-A)
+ *
+ * Node phases and element phases favour different grain sizes, and so do
+ * the cheap (velocity, position) and expensive (hourglass, energy) kernels.
+ * Each trial iteration runs all phases at one candidate size and times every
+ * phase between its release and its done latch; afterwards each phase keeps
+ * the candidate that ran it fastest.
+ *============================================================================*/
+
+#define MAX_TUNE_CANDIDATES 8   // Power-of-two tile sizes tried
+#define TUNE_MIN_TILE 64        // Smallest candidate
+#define TUNE_REPEATS 2          // Timed iterations per candidate (min taken)
+
+typedef struct TileTuner {
+    int phase_tile[MAX_GRAPH_PHASES];       // Chosen size per phase (0 = -T default)
+    int num_candidates;                     // Valid entries in candidates
+    int candidates[MAX_TUNE_CANDIDATES];
+    int trial;                              // -2 idle, -1 warm-up, then timed trials
+    int done;                               // Sizes fixed for the rest of the run
+    int iterations;                         // Iterations spent tuning
+    uint64_t first_ns;                      // Start of the warm-up iteration
+    uint64_t tuning_ns;                     // Wall time of all tuning iterations
+    uint64_t start_ns;                      // Release of the current trial iteration
+    uint64_t phase_end_ns[MAX_GRAPH_PHASES];// Done-latch time per phase, this trial
+    uint64_t best_ns[MAX_GRAPH_PHASES];     // Fastest time per phase so far
+} TileTuner;
+
+extern TileTuner g_tuner;
+
+/*============================================================================
+ * Phase Profiling (-P)
+ *
+ * Each tile EDT gets its graph phase index as a parameter and records its
+ * start/end timestamps into the buffer of the worker running it. The phase
+ * windows are folded at every computeDeltaTimeEdt, which is the only point
+ * where all latches of the iteration are known to have fired.
+ *============================================================================*/
+
+void profileRecordTile(int phase_id, uint64_t start_ns);
+
+static inline uint64_t profileTileBegin(void) {
+    return g_config.profile ? artsGetTimeStamp() : 0;
+}
+
+static inline void profileTileEnd(int phase_id, uint64_t start_ns) {
+    if (start_ns)
+        profileRecordTile(phase_id, start_ns);
+}
+
 /*============================================================================
  * Basic Types
  *============================================================================*/
@@ -119,6 +226,7 @@ struct mesh {
     int nodes_element_neighbors[MAX_NODES][8];        // 8 * number_nodes
     int elements_node_neighbors[MAX_ELEMENTS][8];     // 8 * number_elements
     int elements_element_neighbors[MAX_ELEMENTS][6];  // 6 * number_elements
+    int element_lex_map[MAX_ELEMENTS];                // lexicographic id -> element id
 };
 
 /*============================================================================
@@ -231,18 +339,8 @@ static inline vector cross(vector a, vector b) {
                     a.x * b.y - a.y * b.x};
 }
 
-// Cube root using Newton's method (for TG compatibility)
-static inline double my_cbrt(double x) {
-    if (x == 0.0) return 0.0;
-    double ans = 1.0, old = 0.0;
-    int iter = 0;
-    while (fabs(old - ans) >= PRECISION && iter < 100) {
-        old = ans;
-        ans = (x / (ans * ans) + 2.0 * ans) / 3.0;
-        iter++;
-    }
-    return ans;
-}
+// Cube root shared by all variants (see common/lulesh_cbrt.h)
+#include "lulesh_cbrt.h"
 
 /*============================================================================
  * GUID Index Calculation Helpers
@@ -290,12 +388,61 @@ void computeGradientsTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc,
 void computeViscosityTermsTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
 void computeEnergyTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
 void computeCharacteristicLengthTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+void computeElementGeometryTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
 void computeTimeConstraintsTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
 void computeDeltaTimeEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
 
+// Per-element geometry on gathered corners (shared with the fused kernel)
+void computeVolumeDerivativeFromCorners(int iteration, int element_id, const vertex node_vertices[8],
+                                        const vector node_velocities[8], double dt);
+void computeGradientsFromCorners(int iteration, int element_id, const vertex node_vertices[8],
+                                 const vector node_velocities[8], luleshCtx *ctx);
+void computeCharacteristicLengthFromCorners(int iteration, int element_id, const vertex node_vertices[8]);
+void printGeometryStatistics(luleshCtx *ctx);
+
+// Graph capture/replay
+void instantiateIterationEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+int graphAddPhase(IterationGraph *graph, const char *name, artsEdt_t edt0, artsEdt_t edt1,
+                  int num_items, int num_deps, const int *deps);
+void captureIterationGraph(IterationGraph *graph);
+void instantiateIterationGraph(const IterationGraph *graph, int iteration,
+                               artsGuid_t startEvent, artsGuid_t nextStartEvent);
+void launchNextIteration(int iteration, artsGuid_t nextStartEvent, luleshCtx *ctx);
+void printLaunchStatistics(double elapsed_wall_time);
+
+// Tile-size auto-tuning
+void phaseTimerEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+int parseTileSizes(const char *list);
+void initTileTuner(luleshCtx *ctx);
+int phaseTileSize(int phase_id);
+int tuneActive(void);
+int tuneTiming(void);
+void tuneBeginIteration(void);
+artsGuid_t tuneTimePhase(int phase_id, artsGuid_t doneEvent);
+void instantiateTimedIteration(int iteration);
+void printTileConfig(void);
+
+// Phase profiling
+void profileInit(void);
+void profileIterationStart(void);
+void profileEndIteration(uint64_t start_ns);
+void printPhaseProfile(double elapsed_wall_time);
+
+// Checkpoint/restart
+void checkpointIteration(int iteration, luleshCtx *ctx);
+void checkpointWriteEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]);
+int checkpointDeferShutdown(void);
+int restartFromCheckpoint(luleshCtx *ctx);
+void printCheckpointStatistics(int iterations);
+
 // Helper functions
 void initGraphContext(luleshCtx *ctx);
 void startIteration(int iteration, luleshCtx *ctx);
+void printIterationInfo(int iteration);
+int parseMeshOrdering(const char *name);
+const char *meshOrderingName(int ordering);
+void renumberMesh(luleshCtx *ctx, int ordering);
+void printMeshOrdering(luleshCtx *ctx);
 void parseCommandLine(int argc, char **argv);
 void printUsage(const char *progname);
 
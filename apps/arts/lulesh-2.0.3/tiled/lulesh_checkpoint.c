@@ -0,0 +1,247 @@
+/******************************************************************************
+ * LULESH Tiled ARTS Version - Checkpoint/Restart
+ *
+ * The restart state is the node, element and timing DBs of the buffer the
+ * checkpointed iteration wrote (iteration % 2); partials and gradients are
+ * recomputed from it every timestep. The per-item DBs are gathered into one
+ * staging array inside computeDeltaTimeEdt, and checkpointWriteEdt writes
+ * that array on a spare worker (to <file>.tmp, then fsync and rename).
+ *
+ * The file layout is shared with the optimized and per-element variants.
+ * A due checkpoint is skipped while the previous write is still in flight.
+ * A write still running at the end of the run takes over artsShutdown.
+ ******************************************************************************/
+// fileno is POSIX, not C17
+#define _POSIX_C_SOURCE 200809L
+#include "lulesh.h"
+#include <unistd.h>
+
+extern NodeData *nodeDataPtrs[2][MAX_NODES];
+extern ElementData *elementDataPtrs[2][MAX_ELEMENTS];
+extern TimingData *timingDataPtrs[2];
+
+// Forward declarations
+void allocateIterationData(int iteration, luleshCtx *ctx);
+
+#define CHECKPOINT_MAGIC 0x4b435053454c554cull   // "LULESPCK"
+#define CHECKPOINT_VERSION 1
+
+enum { CHECKPOINT_IDLE = 0, CHECKPOINT_WRITING, CHECKPOINT_SHUTDOWN };
+
+typedef struct CheckpointHeader {
+    uint64_t magic;
+    uint32_t version;
+    int32_t edge_elements;
+    int32_t mesh_ordering;
+    int32_t iteration;
+    int32_t nodes;
+    int32_t elements;
+    uint32_t node_bytes;
+    uint32_t element_bytes;
+    double dt;
+    double elapsed;
+} CheckpointHeader;
+
+typedef struct CheckpointState {
+    int state;                  // CHECKPOINT_* (atomic)
+    CheckpointHeader header;
+    NodeData *nodes;            // Staging copy of the active buffer
+    ElementData *elements;
+    int written;
+    int skipped;
+    int failed;
+    uint64_t bytes;
+    uint64_t copy_ns;           // Critical path: snapshot into staging
+    uint64_t write_ns;          // Background: file write + sync
+} CheckpointState;
+
+static CheckpointState g_checkpoint = {0};
+
+/*============================================================================
+ * Snapshot (critical path)
+ *============================================================================*/
+
+void checkpointIteration(int iteration, luleshCtx *ctx) {
+    if (g_config.checkpoint_interval <= 0 || iteration % g_config.checkpoint_interval != 0)
+        return;
+
+    // One write in flight at a time; the staging area is reused
+    int idle = CHECKPOINT_IDLE;
+    if (!__atomic_compare_exchange_n(&g_checkpoint.state, &idle, CHECKPOINT_WRITING, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        g_checkpoint.skipped++;
+        return;
+    }
+
+    uint64_t t0 = artsGetTimeStamp();
+    int buf = iteration % 2;
+
+    if (!g_checkpoint.nodes) {
+        g_checkpoint.nodes = (NodeData *)malloc(sizeof(NodeData) * ctx->nodes);
+        g_checkpoint.elements = (ElementData *)malloc(sizeof(ElementData) * ctx->elements);
+        assert(g_checkpoint.nodes && g_checkpoint.elements);
+    }
+
+    g_checkpoint.header = (CheckpointHeader){
+        .magic = CHECKPOINT_MAGIC,
+        .version = CHECKPOINT_VERSION,
+        .edge_elements = g_config.edge_elements,
+        .mesh_ordering = g_config.mesh_ordering,
+        .iteration = iteration,
+        .nodes = ctx->nodes,
+        .elements = ctx->elements,
+        .node_bytes = sizeof(NodeData),
+        .element_bytes = sizeof(ElementData),
+        .dt = timingDataPtrs[buf]->dt,
+        .elapsed = timingDataPtrs[buf]->elapsed
+    };
+    for (int node_id = 0; node_id < ctx->nodes; node_id++)
+        g_checkpoint.nodes[node_id] = *nodeDataPtrs[buf][node_id];
+    for (int element_id = 0; element_id < ctx->elements; element_id++)
+        g_checkpoint.elements[element_id] = *elementDataPtrs[buf][element_id];
+
+    g_checkpoint.copy_ns += artsGetTimeStamp() - t0;
+
+    artsEdtCreate(checkpointWriteEdt, 0, 0, NULL, 0);
+}
+
+/*============================================================================
+ * File Write (background)
+ *============================================================================*/
+
+static int writeCheckpointFile(const char *path) {
+    const CheckpointHeader *header = &g_checkpoint.header;
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (!file)
+        return 0;
+
+    int ok = fwrite(header, sizeof(CheckpointHeader), 1, file) == 1 &&
+             fwrite(g_checkpoint.nodes, sizeof(NodeData), header->nodes, file) == (size_t)header->nodes &&
+             fwrite(g_checkpoint.elements, sizeof(ElementData), header->elements, file) == (size_t)header->elements &&
+             fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = (fclose(file) == 0) && ok;
+
+    return ok && rename(tmp_path, path) == 0;
+}
+
+void checkpointWriteEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    uint64_t t0 = artsGetTimeStamp();
+
+    if (writeCheckpointFile(g_config.checkpoint_file)) {
+        g_checkpoint.written++;
+        g_checkpoint.bytes = sizeof(CheckpointHeader) +
+                             sizeof(NodeData) * (uint64_t)g_checkpoint.header.nodes +
+                             sizeof(ElementData) * (uint64_t)g_checkpoint.header.elements;
+    } else {
+        fprintf(stderr, "Error: checkpoint of iteration %d to %s failed\n",
+                g_checkpoint.header.iteration, g_config.checkpoint_file);
+        g_checkpoint.failed++;
+    }
+
+    g_checkpoint.write_ns += artsGetTimeStamp() - t0;
+
+    // If the run ended while writing, shutting down was left to us
+    int writing = CHECKPOINT_WRITING;
+    if (!__atomic_compare_exchange_n(&g_checkpoint.state, &writing, CHECKPOINT_IDLE, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        artsShutdown();
+    }
+}
+
+// Called instead of artsShutdown at the end of the run; returns 1 if a
+// write is still in flight and will shut the runtime down when it lands
+int checkpointDeferShutdown(void) {
+    int writing = CHECKPOINT_WRITING;
+    return __atomic_compare_exchange_n(&g_checkpoint.state, &writing, CHECKPOINT_SHUTDOWN, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/*============================================================================
+ * Restart
+ *============================================================================*/
+
+// Loads the checkpoint into buffer iteration % 2 and returns that iteration
+int restartFromCheckpoint(luleshCtx *ctx) {
+    const char *path = g_config.restart_file;
+    CheckpointHeader header;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: cannot open checkpoint %s\n", path);
+        exit(1);
+    }
+
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION ||
+        header.node_bytes != sizeof(NodeData) || header.element_bytes != sizeof(ElementData)) {
+        fprintf(stderr, "Error: %s is not a LULESH checkpoint\n", path);
+        exit(1);
+    }
+    if (header.edge_elements != g_config.edge_elements || header.mesh_ordering != g_config.mesh_ordering ||
+        header.nodes != ctx->nodes || header.elements != ctx->elements) {
+        fprintf(stderr, "Error: checkpoint %s is for -s %d -O %s\n", path,
+                header.edge_elements, meshOrderingName(header.mesh_ordering));
+        exit(1);
+    }
+
+    NodeData *nodes = (NodeData *)malloc(sizeof(NodeData) * header.nodes);
+    ElementData *elements = (ElementData *)malloc(sizeof(ElementData) * header.elements);
+    assert(nodes && elements);
+    if (fread(nodes, sizeof(NodeData), header.nodes, file) != (size_t)header.nodes ||
+        fread(elements, sizeof(ElementData), header.elements, file) != (size_t)header.elements) {
+        fprintf(stderr, "Error: checkpoint %s is truncated\n", path);
+        exit(1);
+    }
+    fclose(file);
+
+    // Iteration 0 data lives in buffer 0; an odd iteration needs buffer 1
+    int buf = header.iteration % 2;
+    if (buf != 0)
+        allocateIterationData(header.iteration, ctx);
+
+    for (int node_id = 0; node_id < header.nodes; node_id++)
+        *nodeDataPtrs[buf][node_id] = nodes[node_id];
+    for (int element_id = 0; element_id < header.elements; element_id++)
+        *elementDataPtrs[buf][element_id] = elements[element_id];
+    free(elements);
+    free(nodes);
+
+    timingDataPtrs[buf]->dt = header.dt;
+    timingDataPtrs[buf]->elapsed = header.elapsed;
+    g_config.restart_iteration = header.iteration;
+
+    if (header.iteration >= g_config.max_iterations || header.elapsed >= g_config.stop_time) {
+        fprintf(stderr, "Error: checkpoint %s (iteration %d, time %e) is already past -i/-t\n",
+                path, header.iteration, header.elapsed);
+        exit(1);
+    }
+
+    if (!g_config.quiet)
+        PRINTF("Restarting from %s at iteration %d (time %e)\n\n", path, header.iteration, header.elapsed);
+
+    return header.iteration;
+}
+
+/*============================================================================
+ * Report
+ *============================================================================*/
+
+void printCheckpointStatistics(int iterations) {
+    if (g_config.checkpoint_interval <= 0)
+        return;
+
+    double copy = (double)g_checkpoint.copy_ns / 1.0e9;
+    int in_flight = __atomic_load_n(&g_checkpoint.state, __ATOMIC_ACQUIRE) != CHECKPOINT_IDLE;
+
+    PRINTF("Checkpoints          = %d written, %d skipped, %d failed%s (every %d iterations, %.1f MB each)\n",
+           g_checkpoint.written, g_checkpoint.skipped, g_checkpoint.failed,
+           in_flight ? ", 1 in flight" : "", g_config.checkpoint_interval,
+           (double)g_checkpoint.bytes / (1024.0 * 1024.0));
+    PRINTF("Checkpoint overhead  = %10.6f (s)  %8.3f (us/iter) on critical path\n",
+           copy, iterations > 0 ? copy * 1.0e6 / iterations : 0.0);
+    PRINTF("Checkpoint writes    = %10.6f (s)  (overlapped with compute)\n\n",
+           (double)g_checkpoint.write_ns / 1.0e9);
+}
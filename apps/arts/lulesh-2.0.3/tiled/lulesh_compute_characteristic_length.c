@@ -21,15 +21,10 @@ static inline double areaFace(vertex a, vertex b, vertex c, vertex d) {
     return area;
 }
 
-static void computeCharacteristicLengthForElement(int iteration, int element_id, luleshCtx *ctx) {
+// Also called by the fused geometry kernel with corners it already gathered
+void computeCharacteristicLengthFromCorners(int iteration, int element_id, const vertex node_vertices[8]) {
     int curr_buf = iteration % 2;
     
-    vertex node_vertices[8];
-    for (int local_node_id = 0; local_node_id < 8; local_node_id++) {
-        int node_id = ctx->mesh.elements_node_neighbors[element_id][local_node_id];
-        node_vertices[local_node_id] = nodeDataPtrs[curr_buf][node_id]->position;
-    }
-    
     double volume = elementDataPtrs[curr_buf][element_id]->volume;
     
     double charLength = 0.0;
@@ -58,19 +53,35 @@ static void computeCharacteristicLengthForElement(int iteration, int element_id,
     elementDataPtrs[curr_buf][element_id]->characteristic_length = charLength;
 }
 
+static void computeCharacteristicLengthForElement(int iteration, int element_id, luleshCtx *ctx) {
+    int curr_buf = iteration % 2;
+    
+    vertex node_vertices[8];
+    for (int local_node_id = 0; local_node_id < 8; local_node_id++) {
+        int node_id = ctx->mesh.elements_node_neighbors[element_id][local_node_id];
+        node_vertices[local_node_id] = nodeDataPtrs[curr_buf][node_id]->position;
+    }
+    
+    computeCharacteristicLengthFromCorners(iteration, element_id, node_vertices);
+}
+
 void computeCharacteristicLengthTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
     int iteration = (int)paramv[0];
     int tile_id = (int)paramv[1];
     artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int tile_size = (int)paramv[3];
+    int phase_id = (int)paramv[4];
+    uint64_t t0 = profileTileBegin();
     
     luleshCtx *ctx = globalCtx;
     
     int start, end;
-    getTileRange(tile_id, ctx->elements, g_config.tile_size, &start, &end);
+    getTileRange(tile_id, ctx->elements, tile_size, &start, &end);
     
     for (int element_id = start; element_id < end; element_id++) {
         computeCharacteristicLengthForElement(iteration, element_id, ctx);
     }
     
+    profileTileEnd(phase_id, t0);
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
 }
@@ -12,16 +12,10 @@ extern artsGuid_t gradientDataGuids[2][MAX_ELEMENTS];
 extern GradientData *gradientDataPtrs[2][MAX_ELEMENTS];
 extern luleshCtx *globalCtx;
 
-static void computeGradientsForElement(int iteration, int element_id, luleshCtx *ctx) {
+// Also called by the fused geometry kernel with corners it already gathered
+void computeGradientsFromCorners(int iteration, int element_id, const vertex node_vertices[8],
+                                 const vector node_velocities[8], luleshCtx *ctx) {
     int curr_buf = iteration % 2;
-    
-    vertex node_vertices[8];
-    vector node_velocities[8];
-    for (int local_node_id = 0; local_node_id < 8; local_node_id++) {
-        int node_id = ctx->mesh.elements_node_neighbors[element_id][local_node_id];
-        node_vertices[local_node_id] = nodeDataPtrs[curr_buf][node_id]->position;
-        node_velocities[local_node_id] = nodeDataPtrs[curr_buf][node_id]->velocity;
-    }
 
     double volume = elementDataPtrs[curr_buf][element_id]->volume;
 
@@ -107,19 +101,37 @@ static void computeGradientsForElement(int iteration, int element_id, luleshCtx
     gradientDataPtrs[curr_buf][element_id]->velocity_gradient = velocity_gradient;
 }
 
+static void computeGradientsForElement(int iteration, int element_id, luleshCtx *ctx) {
+    int curr_buf = iteration % 2;
+    
+    vertex node_vertices[8];
+    vector node_velocities[8];
+    for (int local_node_id = 0; local_node_id < 8; local_node_id++) {
+        int node_id = ctx->mesh.elements_node_neighbors[element_id][local_node_id];
+        node_vertices[local_node_id] = nodeDataPtrs[curr_buf][node_id]->position;
+        node_velocities[local_node_id] = nodeDataPtrs[curr_buf][node_id]->velocity;
+    }
+
+    computeGradientsFromCorners(iteration, element_id, node_vertices, node_velocities, ctx);
+}
+
 void computeGradientsTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
     int iteration = (int)paramv[0];
     int tile_id = (int)paramv[1];
     artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int tile_size = (int)paramv[3];
+    int phase_id = (int)paramv[4];
+    uint64_t t0 = profileTileBegin();
     
     luleshCtx *ctx = globalCtx;
     
     int start, end;
-    getTileRange(tile_id, ctx->elements, g_config.tile_size, &start, &end);
+    getTileRange(tile_id, ctx->elements, tile_size, &start, &end);
     
     for (int element_id = start; element_id < end; element_id++) {
         computeGradientsForElement(iteration, element_id, ctx);
     }
     
+    profileTileEnd(phase_id, t0);
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
 }
@@ -11,18 +11,12 @@ extern artsGuid_t timingDataGuids[2];
 extern TimingData *timingDataPtrs[2];
 extern luleshCtx *globalCtx;
 
-static void computeVolumeDerivativeForElement(int iteration, int element_id, double dt, luleshCtx *ctx) {
+// Also called by the fused geometry kernel with corners it already gathered
+void computeVolumeDerivativeFromCorners(int iteration, int element_id, const vertex node_vertices[8],
+                                        const vector node_velocities[8], double dt) {
     int curr_buf = iteration % 2;
     double dt2 = 0.5 * dt;
     
-    vertex node_vertices[8];
-    vector node_velocities[8];
-    for (int local_node_id = 0; local_node_id < 8; local_node_id++) {
-        int node_id = ctx->mesh.elements_node_neighbors[element_id][local_node_id];
-        node_vertices[local_node_id] = nodeDataPtrs[curr_buf][node_id]->position;
-        node_velocities[local_node_id] = nodeDataPtrs[curr_buf][node_id]->velocity;
-    }
-    
     vertex temp_vertices[8];
     for (int i = 0; i < 8; i++) {
         temp_vertices[i].x = node_vertices[i].x - dt2 * node_velocities[i].x;
@@ -78,21 +72,39 @@ static void computeVolumeDerivativeForElement(int iteration, int element_id, dou
     elementDataPtrs[curr_buf][element_id]->volume_derivative = volume_derivative;
 }
 
+static void computeVolumeDerivativeForElement(int iteration, int element_id, double dt, luleshCtx *ctx) {
+    int curr_buf = iteration % 2;
+    
+    vertex node_vertices[8];
+    vector node_velocities[8];
+    for (int local_node_id = 0; local_node_id < 8; local_node_id++) {
+        int node_id = ctx->mesh.elements_node_neighbors[element_id][local_node_id];
+        node_vertices[local_node_id] = nodeDataPtrs[curr_buf][node_id]->position;
+        node_velocities[local_node_id] = nodeDataPtrs[curr_buf][node_id]->velocity;
+    }
+    
+    computeVolumeDerivativeFromCorners(iteration, element_id, node_vertices, node_velocities, dt);
+}
+
 void computeVolumeDerivativeTiledEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
     int iteration = (int)paramv[0];
     int tile_id = (int)paramv[1];
     artsGuid_t doneEvent = (artsGuid_t)paramv[2];
+    int tile_size = (int)paramv[3];
+    int phase_id = (int)paramv[4];
+    uint64_t t0 = profileTileBegin();
     
     luleshCtx *ctx = globalCtx;
     int prev_buf = (iteration - 1 + 2) % 2;
     double dt = timingDataPtrs[prev_buf]->dt;
     
     int start, end;
-    getTileRange(tile_id, ctx->elements, g_config.tile_size, &start, &end);
+    getTileRange(tile_id, ctx->elements, tile_size, &start, &end);
     
     for (int element_id = start; element_id < end; element_id++) {
         computeVolumeDerivativeForElement(iteration, element_id, dt, ctx);
     }
     
+    profileTileEnd(phase_id, t0);
     artsEventSatisfySlot(doneEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
 }
@@ -22,7 +22,16 @@ RuntimeConfig g_config = {
     .start_time = 0,
     .tile_size = TILE_SIZE,
     .num_element_tiles = 0,
-    .num_node_tiles = 0
+    .num_node_tiles = 0,
+    .replay_graph = 0,
+    .mesh_ordering = MESH_ORDER_LEXICOGRAPHIC,
+    .auto_tune = 0,
+    .profile = 0,
+    .fuse_geometry = 0,
+    .checkpoint_interval = 0,
+    .checkpoint_file = "lulesh.ckpt",
+    .restart_file = NULL,
+    .restart_iteration = 0
 };
 
 // Per-node arrays (iteration 0 and 1, double buffered)
@@ -60,17 +69,32 @@ void printUsage(const char *progname) {
            DEFAULT_EDGE_ELEMENTS, MAX_EDGE_ELEMENTS);
     printf("  -i <iter>    Maximum iterations (default: 9999999)\n");
     printf("  -t <time>    Stop time (default: 1.0e-2)\n");
-    printf("  -T <tile>    Tile size (elements/nodes per task, default: %d)\n", TILE_SIZE);
+    printf("  -T <tile>    Tile size (elements/nodes per task, default: %d);\n", TILE_SIZE);
+    printf("               a comma-separated list sets one size per phase\n");
+    printf("  -A           Auto-tune per-phase tile sizes over the first iterations\n");
+    printf("  -P           Report per-phase/per-tile timing at shutdown\n");
+    printf("  -f           Fuse volume-deriv, gradients and char-length into one phase\n");
+    printf("  -C <n>       Checkpoint every n iterations (default: off)\n");
+    printf("  -F <file>    Checkpoint file (default: lulesh.ckpt)\n");
+    printf("  -restart <file>  Resume from a checkpoint (same -s and -O)\n");
+    printf("  -R           Capture the iteration graph once and replay it\n");
+    printf("  -O <order>   Node/element ordering: lex, morton, hilbert (default: lex)\n");
     printf("  -p           Show iteration progress (default: on)\n");
     printf("  -q           Quiet mode (minimal output)\n");
     printf("  -h           Show this help message\n");
 }
 
+static const struct option long_options[] = {
+    {"restart", required_argument, NULL, 'X'},
+    {NULL, 0, NULL, 0}
+};
+
 void parseCommandLine(int argc, char **argv) {
     int opt;
     optind = 1;
     
-    while ((opt = getopt(argc, argv, "s:i:t:T:pqh")) != -1) {
+    // getopt_long_only so that -restart works with a single dash
+    while ((opt = getopt_long_only(argc, argv, "s:i:t:T:ARO:PfC:F:pqh", long_options, NULL)) != -1) {
         switch (opt) {
             case 's':
                 g_config.edge_elements = atoi(optarg);
@@ -98,10 +122,40 @@ void parseCommandLine(int argc, char **argv) {
                 }
                 break;
             case 'T':
-                g_config.tile_size = atoi(optarg);
-                if (g_config.tile_size < 1) {
-                    fprintf(stderr, "Error: tile size must be at least 1\n");
-                    g_config.tile_size = TILE_SIZE;
+                if (parseTileSizes(optarg) < 0) {
+                    fprintf(stderr, "Error: tile sizes must be positive integers separated by commas\n");
+                }
+                break;
+            case 'A':
+                g_config.auto_tune = 1;
+                break;
+            case 'P':
+                g_config.profile = 1;
+                break;
+            case 'C':
+                g_config.checkpoint_interval = atoi(optarg);
+                if (g_config.checkpoint_interval < 0) {
+                    fprintf(stderr, "Error: checkpoint interval must be non-negative\n");
+                    g_config.checkpoint_interval = 0;
+                }
+                break;
+            case 'F':
+                g_config.checkpoint_file = optarg;
+                break;
+            case 'X':
+                g_config.restart_file = optarg;
+                break;
+            case 'R':
+                g_config.replay_graph = 1;
+                break;
+            case 'f':
+                g_config.fuse_geometry = 1;
+                break;
+            case 'O':
+                g_config.mesh_ordering = parseMeshOrdering(optarg);
+                if (g_config.mesh_ordering < 0) {
+                    fprintf(stderr, "Error: unknown ordering '%s' (lex, morton, hilbert)\n", optarg);
+                    g_config.mesh_ordering = MESH_ORDER_LEXICOGRAPHIC;
                 }
                 break;
             case 'p':
@@ -137,6 +191,7 @@ void initGraphContext(luleshCtx *ctx) {
     // Calculate number of tiles
     g_config.num_element_tiles = (elements + g_config.tile_size - 1) / g_config.tile_size;
     g_config.num_node_tiles = (nodes + g_config.tile_size - 1) / g_config.tile_size;
+    initTileTuner(ctx);
 
     // Initialize the domain constants
     ctx->constants = (struct constants){
@@ -291,6 +346,8 @@ void initGraphContext(luleshCtx *ctx) {
 
     double delta_time = 0.5 * my_cbrt(ctx->domain.element_volume[0]) / sqrt(2.0 * einit);
     ctx->domain.initial_delta_time = delta_time;
+
+    renumberMesh(ctx, g_config.mesh_ordering);
 }
 
 /*============================================================================
@@ -403,145 +460,115 @@ void allocateIterationData(int iteration, luleshCtx *ctx) {
     }
 }
 
+/*============================================================================
+ * Iteration Graph Template
+ *============================================================================*/
+
+void captureIterationGraph(IterationGraph *graph) {
+    int elements = globalCtx->elements;
+    int nodes = globalCtx->nodes;
+
+    memset(graph, 0, sizeof(IterationGraph));
+
+    // Phase 1: Stress and Hourglass partials (tiled per element)
+    int phase1 = graphAddPhase(graph, "partials", computeStressPartialTiledEdt,
+                               computeHourglassPartialTiledEdt, elements, 0, NULL);
+
+    // Phases 2-4: Reduce force, velocity, position (tiled per node)
+    int phase2 = graphAddPhase(graph, "reduce-force", reduceForceTiledEdt, NULL, nodes, 1, &phase1);
+    int phase3 = graphAddPhase(graph, "velocity", computeVelocityTiledEdt, NULL, nodes, 1, &phase2);
+    int phase4 = graphAddPhase(graph, "position", computePositionTiledEdt, NULL, nodes, 1, &phase3);
+
+    // Phase 5: Volume computation (tiled per element)
+    int phase5 = graphAddPhase(graph, "volume", computeVolumeTiledEdt, NULL, elements, 1, &phase4);
+
+    // With -f one phase gathers each element's corners once and produces the
+    // volume derivative, gradients and characteristic length together
+    if (g_config.fuse_geometry) {
+        int geometry = graphAddPhase(graph, "geometry", computeElementGeometryTiledEdt, NULL, elements, 1, &phase5);
+        int viscosity = graphAddPhase(graph, "viscosity", computeViscosityTermsTiledEdt, NULL, elements, 1, &geometry);
+        int energy = graphAddPhase(graph, "energy", computeEnergyTiledEdt, NULL, elements, 1, &viscosity);
+        int deps[2] = {geometry, energy};
+        graphAddPhase(graph, "time-constraints", computeTimeConstraintsTiledEdt, NULL, elements, 2, deps);
+        return;
+    }
+
+    // Phases 6, 7 and 10 only need the new volume
+    int phase6 = graphAddPhase(graph, "volume-deriv", computeVolumeDerivativeTiledEdt, NULL, elements, 1, &phase5);
+    int phase7 = graphAddPhase(graph, "gradients", computeGradientsTiledEdt, NULL, elements, 1, &phase5);
+
+    // Phase 8: Viscosity terms wait on phases 6 and 7
+    int deps67[2] = {phase6, phase7};
+    int phase8 = graphAddPhase(graph, "viscosity", computeViscosityTermsTiledEdt, NULL, elements, 2, deps67);
+
+    // Phase 9: Energy computation (tiled per element)
+    int phase9 = graphAddPhase(graph, "energy", computeEnergyTiledEdt, NULL, elements, 1, &phase8);
+
+    // Phase 10: Characteristic length (tiled per element)
+    int phase10 = graphAddPhase(graph, "char-length", computeCharacteristicLengthTiledEdt, NULL, elements, 1, &phase5);
+
+    // Phase 11: Time constraints wait on phases 6, 9 and 10
+    // Phase 12 (computeDeltaTimeEdt) is attached to the sink phase
+    int deps6910[3] = {phase6, phase9, phase10};
+    graphAddPhase(graph, "time-constraints", computeTimeConstraintsTiledEdt, NULL, elements, 3, deps6910);
+}
+
 /*============================================================================
  * Spawn Tiled EDTs for One Iteration
  *============================================================================*/
 
-void startIteration(int iteration, luleshCtx *ctx) {
-    // Print iteration info
+void printIterationInfo(int iteration) {
+    int prev_buf = (iteration - 1 + 2) % 2;
+
     if (!g_config.quiet) {
-        int prev_buf = (iteration - 1 + 2) % 2;
         double delta_time = timingDataPtrs[prev_buf]->dt;
-        double energy = elementDataPtrs[prev_buf][0]->energy;
+        int origin_id = globalCtx->mesh.element_lex_map[0];
+        double energy = elementDataPtrs[prev_buf][origin_id]->energy;
         PRINTF("iteration %d, delta time %f, energy %f\n", iteration, delta_time, energy);
     }
 
     if (g_config.show_progress && !g_config.quiet) {
-        int prev_buf = (iteration - 1 + 2) % 2;
         PRINTF("cycle = %d, time = %e, dt=%e\n", iteration,
                timingDataPtrs[prev_buf]->elapsed, timingDataPtrs[prev_buf]->dt);
     }
+}
 
-    allocateIterationData(iteration, ctx);
-    
-    int num_elem_tiles = g_config.num_element_tiles;
-    int num_node_tiles = g_config.num_node_tiles;
-    
-    // Phase 1: Stress and Hourglass partials (tiled per element)
-    artsGuid_t phase1DoneEvent = artsEventCreate(0, num_elem_tiles * 2);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase1DoneEvent};
-        artsEdtCreate(computeStressPartialTiledEdt, 0, 3, params, 0);
-        artsEdtCreate(computeHourglassPartialTiledEdt, 0, 3, params, 0);
-    }
-    
-    // Phase 2: Reduce force (tiled per node)
-    artsGuid_t phase2DoneEvent = artsEventCreate(0, num_node_tiles);
-    
-    for (int tile_id = 0; tile_id < num_node_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase2DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(reduceForceTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase1DoneEvent, edtGuid, 0);
-    }
-    
-    // Phase 3: Velocity computation (tiled per node)
-    artsGuid_t phase3DoneEvent = artsEventCreate(0, num_node_tiles);
-    
-    for (int tile_id = 0; tile_id < num_node_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase3DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeVelocityTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase2DoneEvent, edtGuid, 0);
-    }
-    
-    // Phase 4: Position computation (tiled per node)
-    artsGuid_t phase4DoneEvent = artsEventCreate(0, num_node_tiles);
-    
-    for (int tile_id = 0; tile_id < num_node_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase4DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computePositionTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase3DoneEvent, edtGuid, 0);
-    }
-    
-    // Phase 5: Volume computation (tiled per element)
-    artsGuid_t phase5DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase5DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeVolumeTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase4DoneEvent, edtGuid, 0);
-    }
-    
-    // Phase 6: Volume derivative (tiled per element)
-    artsGuid_t phase6DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase6DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeVolumeDerivativeTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase5DoneEvent, edtGuid, 0);
-    }
-    
-    // Phase 7: Gradients computation (tiled per element)
-    artsGuid_t phase7DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase7DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeGradientsTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase5DoneEvent, edtGuid, 0);
-    }
-    
-    // Combined event for phases 6 and 7
-    artsGuid_t phase67DoneEvent = artsEventCreate(0, 2);
-    artsAddDependence(phase6DoneEvent, phase67DoneEvent, ARTS_EVENT_LATCH_DECR_SLOT);
-    artsAddDependence(phase7DoneEvent, phase67DoneEvent, ARTS_EVENT_LATCH_DECR_SLOT);
-    
-    // Phase 8: Viscosity terms (tiled per element)
-    artsGuid_t phase8DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase8DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeViscosityTermsTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase67DoneEvent, edtGuid, 0);
-    }
-    
-    // Phase 9: Energy computation (tiled per element)
-    artsGuid_t phase9DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase9DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeEnergyTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase8DoneEvent, edtGuid, 0);
+void startIteration(int iteration, luleshCtx *ctx) {
+    printIterationInfo(iteration);
+    profileIterationStart();
+
+    // Auto-tuning swaps tile sizes between iterations and recaptures
+    tuneBeginIteration();
+
+    if (g_graph.num_phases == 0) {
+        uint64_t t0 = artsGetTimeStamp();
+        captureIterationGraph(&g_graph);
+        g_launch.capture_ns += artsGetTimeStamp() - t0;
     }
-    
-    // Phase 10: Characteristic length (tiled per element)
-    artsGuid_t phase10DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase10DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeCharacteristicLengthTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase5DoneEvent, edtGuid, 0);
+
+    allocateIterationData(iteration, ctx);
+
+    if (tuneTiming()) {
+        instantiateTimedIteration(iteration);
+        return;
     }
-    
-    // Combined event for phases 6, 9, and 10
-    artsGuid_t phase6910DoneEvent = artsEventCreate(0, 3);
-    artsAddDependence(phase6DoneEvent, phase6910DoneEvent, ARTS_EVENT_LATCH_DECR_SLOT);
-    artsAddDependence(phase9DoneEvent, phase6910DoneEvent, ARTS_EVENT_LATCH_DECR_SLOT);
-    artsAddDependence(phase10DoneEvent, phase6910DoneEvent, ARTS_EVENT_LATCH_DECR_SLOT);
-    
-    // Phase 11: Time constraints (tiled per element)
-    artsGuid_t phase11DoneEvent = artsEventCreate(0, num_elem_tiles);
-    
-    for (int tile_id = 0; tile_id < num_elem_tiles; tile_id++) {
-        uint64_t params[3] = {iteration, tile_id, (uint64_t)phase11DoneEvent};
-        artsGuid_t edtGuid = artsEdtCreate(computeTimeConstraintsTiledEdt, 0, 3, params, 1);
-        artsAddDependence(phase6910DoneEvent, edtGuid, 0);
+
+    if (!g_config.replay_graph || tuneActive()) {
+        instantiateIterationGraph(&g_graph, iteration, NULL_GUID, NULL_GUID);
+        return;
     }
-    
-    // Phase 12: Delta time computation (single task)
-    {
-        uint64_t params[1] = {iteration};
-        artsGuid_t edtGuid = artsEdtCreate(computeDeltaTimeEdt, 0, 1, params, 1);
-        artsAddDependence(phase11DoneEvent, edtGuid, 0);
+
+    // Replay keeps the DB set of iterations 0 and 1 for the whole run, so
+    // the next iteration can be instantiated while this one computes
+    artsGuid_t nextStartEvent = NULL_GUID;
+    if (iteration < g_config.max_iterations)
+        nextStartEvent = artsEventCreate(0, 1);
+
+    instantiateIterationGraph(&g_graph, iteration, NULL_GUID, nextStartEvent);
+
+    if (nextStartEvent != NULL_GUID) {
+        uint64_t params[2] = {iteration + 1, (uint64_t)nextStartEvent};
+        artsEdtCreate(instantiateIterationEdt, 0, 2, params, 0);
     }
 }
 
@@ -573,7 +600,13 @@ void initPerWorker(unsigned int nodeId, unsigned int workerId, int argc, char **
         
         initializeIteration0Data(globalCtx);
         
-        startIteration(1, globalCtx);
+        // Resume after the checkpointed iteration when restarting
+        int first_iteration = 1;
+        if (g_config.restart_file)
+            first_iteration = restartFromCheckpoint(globalCtx) + 1;
+
+        profileInit();
+        startIteration(first_iteration, globalCtx);
     }
 }
 
@@ -0,0 +1,261 @@
+/******************************************************************************
+ * LULESH Tiled ARTS Version - Space-Filling-Curve Mesh Ordering
+ *
+ * getTileRange hands each task a contiguous index range. With the default
+ * lexicographic numbering, that range is a thin slab of the cube. Renumbering
+ * nodes and elements along a Morton or Hilbert curve makes each range a
+ * compact brick, so a tile touches fewer distinct nodes and partial slots.
+ *
+ * The mesh is always built lexicographically, then permuted in place.
+ * mesh.element_lex_map keeps the lexicographic view for the origin-energy
+ * and symmetry checks.
+ ******************************************************************************/
+#include "lulesh.h"
+
+static const char *ordering_names[] = {"lex", "morton", "hilbert"};
+
+int parseMeshOrdering(const char *name) {
+    for (int i = 0; i < (int)(sizeof(ordering_names) / sizeof(ordering_names[0])); i++) {
+        if (strcmp(name, ordering_names[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+const char *meshOrderingName(int ordering) {
+    return ordering_names[ordering];
+}
+
+/*============================================================================
+ * Curve Keys
+ *============================================================================*/
+
+static uint64_t mortonKey(uint32_t x, uint32_t y, uint32_t z, int bits) {
+    uint64_t key = 0;
+    for (int bit = bits - 1; bit >= 0; bit--) {
+        key = (key << 3) | (((z >> bit) & 1) << 2) | (((y >> bit) & 1) << 1) | ((x >> bit) & 1);
+    }
+    return key;
+}
+
+// Skilling's transposed Hilbert index ("Programming the Hilbert curve", 2004)
+static uint64_t hilbertKey(uint32_t x, uint32_t y, uint32_t z, int bits) {
+    uint32_t X[3] = {z, y, x};
+    uint32_t M = 1u << (bits - 1);
+    uint32_t P, Q, t;
+
+    // Inverse undo of excess work
+    for (Q = M; Q > 1; Q >>= 1) {
+        P = Q - 1;
+        for (int i = 0; i < 3; i++) {
+            if (X[i] & Q) {
+                X[0] ^= P;
+            } else {
+                t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    for (int i = 1; i < 3; i++)
+        X[i] ^= X[i - 1];
+    t = 0;
+    for (Q = M; Q > 1; Q >>= 1) {
+        if (X[2] & Q)
+            t ^= Q - 1;
+    }
+    for (int i = 0; i < 3; i++)
+        X[i] ^= t;
+
+    uint64_t key = 0;
+    for (int bit = bits - 1; bit >= 0; bit--) {
+        for (int i = 0; i < 3; i++)
+            key = (key << 1) | ((X[i] >> bit) & 1);
+    }
+    return key;
+}
+
+typedef struct CurveEntry {
+    uint64_t key;
+    int lex_id;
+} CurveEntry;
+
+static int compareCurveEntries(const void *a, const void *b) {
+    const CurveEntry *ea = (const CurveEntry *)a;
+    const CurveEntry *eb = (const CurveEntry *)b;
+    if (ea->key != eb->key)
+        return ea->key < eb->key ? -1 : 1;
+    return ea->lex_id - eb->lex_id;
+}
+
+// new_id[lex_id] = position of (column, row, plane) along the curve
+static void buildCurveOrder(int edge, int bits, int ordering, int *new_id) {
+    int count = edge * edge * edge;
+    CurveEntry *entries = (CurveEntry *)malloc(sizeof(CurveEntry) * count);
+    assert(entries);
+
+    int lex_id = 0;
+    for (int plane_id = 0; plane_id < edge; plane_id++) {
+        for (int row_id = 0; row_id < edge; row_id++) {
+            for (int column_id = 0; column_id < edge; column_id++) {
+                entries[lex_id].key = (ordering == MESH_ORDER_HILBERT)
+                    ? hilbertKey(column_id, row_id, plane_id, bits)
+                    : mortonKey(column_id, row_id, plane_id, bits);
+                entries[lex_id].lex_id = lex_id;
+                lex_id++;
+            }
+        }
+    }
+
+    qsort(entries, count, sizeof(CurveEntry), compareCurveEntries);
+    for (int i = 0; i < count; i++)
+        new_id[entries[i].lex_id] = i;
+
+    free(entries);
+}
+
+static inline int remapId(const int *new_id, int id) {
+    return id >= 0 ? new_id[id] : id;
+}
+
+/*============================================================================
+ * Renumber the Lexicographic Mesh
+ *============================================================================*/
+
+void renumberMesh(luleshCtx *ctx, int ordering) {
+    int elements = ctx->elements;
+    int nodes = ctx->nodes;
+
+    if (ordering == MESH_ORDER_LEXICOGRAPHIC) {
+        for (int element_id = 0; element_id < elements; element_id++)
+            ctx->mesh.element_lex_map[element_id] = element_id;
+        return;
+    }
+
+    int edge_elements = g_config.edge_elements;
+    int edge_nodes = edge_elements + 1;
+    int bits = 1;
+    while ((1 << bits) < edge_nodes)
+        bits++;
+
+    int *node_new = (int *)malloc(sizeof(int) * nodes);
+    int *element_new = (int *)malloc(sizeof(int) * elements);
+    struct domain *old_domain = (struct domain *)malloc(sizeof(struct domain));
+    struct mesh *old_mesh = (struct mesh *)malloc(sizeof(struct mesh));
+    assert(node_new && element_new && old_domain && old_mesh);
+
+    buildCurveOrder(edge_nodes, bits, ordering, node_new);
+    buildCurveOrder(edge_elements, bits, ordering, element_new);
+
+    memcpy(old_domain, &ctx->domain, sizeof(struct domain));
+    memcpy(old_mesh, &ctx->mesh, sizeof(struct mesh));
+
+    struct domain *domain = &ctx->domain;
+    struct mesh *mesh = &ctx->mesh;
+
+    for (int old_id = 0; old_id < nodes; old_id++) {
+        int id = node_new[old_id];
+        domain->node_mass[id] = old_domain->node_mass[old_id];
+        domain->initial_force[id] = old_domain->initial_force[old_id];
+        domain->initial_velocity[id] = old_domain->initial_velocity[old_id];
+        domain->initial_position[id] = old_domain->initial_position[old_id];
+
+        // Slot order is geometric and stays put; only the ids move
+        for (int i = 0; i < 6; i++)
+            mesh->nodes_node_neighbors[id][i] = remapId(node_new, old_mesh->nodes_node_neighbors[old_id][i]);
+        for (int i = 0; i < 8; i++)
+            mesh->nodes_element_neighbors[id][i] = remapId(element_new, old_mesh->nodes_element_neighbors[old_id][i]);
+    }
+
+    for (int old_id = 0; old_id < elements; old_id++) {
+        int id = element_new[old_id];
+        domain->element_mass[id] = old_domain->element_mass[old_id];
+        domain->element_volume[id] = old_domain->element_volume[old_id];
+        domain->initial_volume[id] = old_domain->initial_volume[old_id];
+        domain->initial_viscosity[id] = old_domain->initial_viscosity[old_id];
+        domain->initial_pressure[id] = old_domain->initial_pressure[old_id];
+        domain->initial_energy[id] = old_domain->initial_energy[old_id];
+        domain->initial_speed_sound[id] = old_domain->initial_speed_sound[old_id];
+
+        for (int i = 0; i < 8; i++)
+            mesh->elements_node_neighbors[id][i] = remapId(node_new, old_mesh->elements_node_neighbors[old_id][i]);
+        for (int i = 0; i < 6; i++)
+            mesh->elements_element_neighbors[id][i] = remapId(element_new, old_mesh->elements_element_neighbors[old_id][i]);
+
+        mesh->element_lex_map[old_id] = id;
+    }
+
+    free(old_mesh);
+    free(old_domain);
+    free(element_new);
+    free(node_new);
+}
+
+/*============================================================================
+ * Tile Locality Report
+ *============================================================================*/
+
+// Nodes touched per element tile of the given size, how often each is
+// reused across the tile's elements, and the spread of its node indices
+static void tileLocality(luleshCtx *ctx, int tile_size, int *last_tile,
+                         double *nodes_per_tile, double *reuse, double *span) {
+    int num_tiles = (ctx->elements + tile_size - 1) / tile_size;
+    for (int node_id = 0; node_id < ctx->nodes; node_id++)
+        last_tile[node_id] = -1;
+
+    double unique_nodes = 0.0;
+    double node_span = 0.0;
+
+    for (int tile_id = 0; tile_id < num_tiles; tile_id++) {
+        int start, end;
+        getTileRange(tile_id, ctx->elements, tile_size, &start, &end);
+
+        int lo = ctx->nodes, hi = -1;
+        for (int element_id = start; element_id < end; element_id++) {
+            for (int i = 0; i < 8; i++) {
+                int node_id = ctx->mesh.elements_node_neighbors[element_id][i];
+                if (last_tile[node_id] != tile_id) {
+                    last_tile[node_id] = tile_id;
+                    unique_nodes += 1.0;
+                }
+                if (node_id < lo) lo = node_id;
+                if (node_id > hi) hi = node_id;
+            }
+        }
+        node_span += hi - lo + 1;
+    }
+
+    *nodes_per_tile = unique_nodes / num_tiles;
+    *reuse = 8.0 * ctx->elements / unique_nodes;
+    *span = node_span / num_tiles;
+}
+
+// One line per element phase, as -T lists and -A tunes can give each phase
+// its own tile size; node phases do not gather through the mesh
+void printMeshOrdering(luleshCtx *ctx) {
+    int *last_tile = (int *)malloc(sizeof(int) * ctx->nodes);
+    assert(last_tile);
+    double nodes_per_tile, reuse, span;
+
+    PRINTF("Mesh ordering        = %s\n", meshOrderingName(g_config.mesh_ordering));
+    int printed = 0;
+    for (int phase_id = 0; phase_id < g_graph.num_phases; phase_id++) {
+        const GraphPhase *phase = &g_graph.phases[phase_id];
+        if (phase->num_items != ctx->elements)
+            continue;
+        tileLocality(ctx, phase->tile_size, last_tile, &nodes_per_tile, &reuse, &span);
+        PRINTF("  %-18s = T %-5d (%.1f nodes/tile, node reuse %.2fx, node span %.1f)\n",
+               phase->name, phase->tile_size, nodes_per_tile, reuse, span);
+        printed++;
+    }
+    // The graph is empty when the run ended just before a recapture
+    if (!printed) {
+        tileLocality(ctx, g_config.tile_size, last_tile, &nodes_per_tile, &reuse, &span);
+        PRINTF("  %-18s = T %-5d (%.1f nodes/tile, node reuse %.2fx, node span %.1f)\n",
+               "all phases", g_config.tile_size, nodes_per_tile, reuse, span);
+    }
+    PRINTF("\n");
+    free(last_tile);
+}
@@ -0,0 +1,282 @@
+/******************************************************************************
+ * LULESH Tiled ARTS Version - Per-Phase Timing Breakdown (-P)
+ *
+ * Per-tile durations and per-phase windows are recorded by the worker that
+ * runs each tile, with no shared state until computeDeltaTimeEdt folds them.
+ * The graph template supplies the latch structure: a phase's gap runs from
+ * the last of its predecessors finishing (e.g. phases 6, 9 and 10 before
+ * time constraints) to its own first tile starting. The critical-path
+ * estimate chains the longest tile of each phase along the same edges.
+ * Phases 6, 7 and 10 overlap, so their spans can add up to more than the
+ * iteration.
+ ******************************************************************************/
+#include "lulesh.h"
+
+#define PROFILE_MAX_PHASES MAX_GRAPH_PHASES
+
+// Exact below 8 ns, then 8 sub-buckets per power of two (<= 12.5% error)
+#define PROFILE_SUB_BITS 3
+#define PROFILE_SUB_BUCKETS (1 << PROFILE_SUB_BITS)
+#define PROFILE_BUCKETS 256
+
+typedef struct TileStats {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint32_t histogram[PROFILE_BUCKETS];
+} TileStats;
+
+typedef struct PhaseWindow {
+    uint64_t first_start;
+    uint64_t last_end;
+    uint64_t max_tile;
+} PhaseWindow;
+
+// One per worker, cache-line aligned so recording never shares a line
+typedef struct WorkerProfile {
+    PhaseWindow window[PROFILE_MAX_PHASES];
+    TileStats tiles[PROFILE_MAX_PHASES];
+} __attribute__((aligned(64))) WorkerProfile;
+
+typedef struct PhaseProfile {
+    int num_workers;
+    WorkerProfile *workers;
+    int iterations;
+    uint64_t iteration_start;
+    uint64_t iteration_ns;
+    uint64_t critical_ns;
+    uint64_t span_ns[PROFILE_MAX_PHASES];
+    uint64_t gap_ns[PROFILE_MAX_PHASES];
+    uint64_t delta_gap_ns;
+    TileStats delta;
+} PhaseProfile;
+
+static PhaseProfile g_profile;
+
+/*============================================================================
+ * Phase Table (from the captured iteration graph)
+ *============================================================================*/
+
+static int phaseCount(void) {
+    return g_graph.num_phases;
+}
+
+static const char *phaseName(int phase_id) {
+    return g_graph.phases[phase_id].name;
+}
+
+static int phaseDeps(int phase_id, const int **deps) {
+    *deps = g_graph.phases[phase_id].deps;
+    return g_graph.phases[phase_id].num_deps;
+}
+
+/*============================================================================
+ * Histogram
+ *============================================================================*/
+
+static int bucketOf(uint64_t ns) {
+    if (ns < PROFILE_SUB_BUCKETS)
+        return (int)ns;
+    int exp = 63 - __builtin_clzll(ns);
+    int bucket = (exp - PROFILE_SUB_BITS + 1) * PROFILE_SUB_BUCKETS +
+                 (int)((ns >> (exp - PROFILE_SUB_BITS)) & (PROFILE_SUB_BUCKETS - 1));
+    return bucket < PROFILE_BUCKETS ? bucket : PROFILE_BUCKETS - 1;
+}
+
+// Midpoint of a bucket's range
+static uint64_t bucketValue(int bucket) {
+    if (bucket < PROFILE_SUB_BUCKETS)
+        return (uint64_t)bucket;
+    int exp = bucket / PROFILE_SUB_BUCKETS + PROFILE_SUB_BITS - 1;
+    uint64_t mantissa = PROFILE_SUB_BUCKETS + bucket % PROFILE_SUB_BUCKETS;
+    uint64_t width = 1ull << (exp - PROFILE_SUB_BITS);
+    return mantissa * width + width / 2;
+}
+
+static void addSample(TileStats *stats, uint64_t ns) {
+    if (stats->count == 0 || ns < stats->min_ns)
+        stats->min_ns = ns;
+    if (ns > stats->max_ns)
+        stats->max_ns = ns;
+    stats->count++;
+    stats->total_ns += ns;
+    stats->histogram[bucketOf(ns)]++;
+}
+
+static void mergeStats(TileStats *dst, const TileStats *src) {
+    if (src->count == 0)
+        return;
+    if (dst->count == 0 || src->min_ns < dst->min_ns)
+        dst->min_ns = src->min_ns;
+    if (src->max_ns > dst->max_ns)
+        dst->max_ns = src->max_ns;
+    dst->count += src->count;
+    dst->total_ns += src->total_ns;
+    for (int b = 0; b < PROFILE_BUCKETS; b++)
+        dst->histogram[b] += src->histogram[b];
+}
+
+static uint64_t statsMedian(const TileStats *stats) {
+    uint64_t target = (stats->count + 1) / 2;
+    uint64_t seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        seen += stats->histogram[b];
+        if (seen >= target) {
+            uint64_t value = bucketValue(b);
+            if (value < stats->min_ns) value = stats->min_ns;
+            if (value > stats->max_ns) value = stats->max_ns;
+            return value;
+        }
+    }
+    return stats->max_ns;
+}
+
+/*============================================================================
+ * Recording
+ *============================================================================*/
+
+void profileInit(void) {
+    if (!g_config.profile)
+        return;
+
+    g_profile.num_workers = artsGetTotalWorkers();
+    size_t bytes = sizeof(WorkerProfile) * g_profile.num_workers;
+    g_profile.workers = (WorkerProfile *)aligned_alloc(64, bytes);
+    assert(g_profile.workers);
+    memset(g_profile.workers, 0, bytes);
+}
+
+void profileRecordTile(int phase_id, uint64_t start_ns) {
+    uint64_t end_ns = artsGetTimeStamp();
+    uint64_t ns = end_ns - start_ns;
+    WorkerProfile *worker = &g_profile.workers[artsGetCurrentWorker()];
+    PhaseWindow *window = &worker->window[phase_id];
+
+    if (window->last_end == 0 || start_ns < window->first_start)
+        window->first_start = start_ns;
+    if (end_ns > window->last_end)
+        window->last_end = end_ns;
+    if (ns > window->max_tile)
+        window->max_tile = ns;
+
+    addSample(&worker->tiles[phase_id], ns);
+}
+
+// Marks the release of an iteration's first phase
+void profileIterationStart(void) {
+    if (g_config.profile)
+        g_profile.iteration_start = artsGetTimeStamp();
+}
+
+// Called by computeDeltaTimeEdt (start_ns from profileTileBegin) once every
+// latch of the iteration has fired and before the next one is launched
+void profileEndIteration(uint64_t start_ns) {
+    if (!start_ns)
+        return;
+
+    uint64_t end_ns = artsGetTimeStamp();
+    int num_phases = phaseCount();
+    PhaseWindow merged[PROFILE_MAX_PHASES];
+    uint64_t path[PROFILE_MAX_PHASES];
+    uint64_t longest = 0;
+    uint64_t last_end = g_profile.iteration_start;
+
+    for (int phase_id = 0; phase_id < num_phases; phase_id++) {
+        PhaseWindow *m = &merged[phase_id];
+        m->first_start = UINT64_MAX;
+        m->last_end = 0;
+        m->max_tile = 0;
+        for (int w = 0; w < g_profile.num_workers; w++) {
+            PhaseWindow *window = &g_profile.workers[w].window[phase_id];
+            if (window->last_end == 0)
+                continue;
+            if (window->first_start < m->first_start) m->first_start = window->first_start;
+            if (window->last_end > m->last_end) m->last_end = window->last_end;
+            if (window->max_tile > m->max_tile) m->max_tile = window->max_tile;
+            memset(window, 0, sizeof(PhaseWindow));
+        }
+    }
+
+    // Phases are recorded in dependence order, so one forward pass suffices
+    for (int phase_id = 0; phase_id < num_phases; phase_id++) {
+        const int *deps;
+        int num_deps = phaseDeps(phase_id, &deps);
+        uint64_t ready = g_profile.iteration_start;
+        uint64_t chain = 0;
+        for (int i = 0; i < num_deps; i++) {
+            if (merged[deps[i]].last_end > ready) ready = merged[deps[i]].last_end;
+            if (path[deps[i]] > chain) chain = path[deps[i]];
+        }
+        path[phase_id] = chain + merged[phase_id].max_tile;
+        if (path[phase_id] > longest)
+            longest = path[phase_id];
+
+        if (merged[phase_id].last_end == 0)
+            continue;
+        g_profile.span_ns[phase_id] += merged[phase_id].last_end - merged[phase_id].first_start;
+        if (merged[phase_id].first_start > ready)
+            g_profile.gap_ns[phase_id] += merged[phase_id].first_start - ready;
+        if (merged[phase_id].last_end > last_end)
+            last_end = merged[phase_id].last_end;
+    }
+
+    if (start_ns > last_end)
+        g_profile.delta_gap_ns += start_ns - last_end;
+    addSample(&g_profile.delta, end_ns - start_ns);
+
+    g_profile.critical_ns += longest + (end_ns - start_ns);
+    g_profile.iteration_ns += end_ns - g_profile.iteration_start;
+    g_profile.iterations++;
+}
+
+/*============================================================================
+ * Shutdown Report
+ *============================================================================*/
+
+static void printPhaseRow(const char *name, const TileStats *stats, uint64_t span_ns,
+                          uint64_t gap_ns, double iterations) {
+    PRINTF("  %-18s %8.1f %10.2f %10.2f %10.2f %11.2f %11.2f %11.2f\n", name,
+           stats->count / iterations,
+           stats->min_ns / 1.0e3, statsMedian(stats) / 1.0e3, stats->max_ns / 1.0e3,
+           stats->total_ns / iterations / 1.0e3, span_ns / iterations / 1.0e3,
+           gap_ns / iterations / 1.0e3);
+}
+
+void printPhaseProfile(double elapsed_wall_time) {
+    if (!g_config.profile || g_profile.iterations == 0)
+        return;
+
+    double iterations = g_profile.iterations;
+    uint64_t busy_ns = 0;
+    uint64_t gap_ns = g_profile.delta_gap_ns;
+
+    PRINTF("Phase profile        = %d iterations, %d workers (busy/span/gap per iteration)\n",
+           g_profile.iterations, g_profile.num_workers);
+    PRINTF("  %-18s %8s %10s %10s %10s %11s %11s %11s\n", "phase", "tiles",
+           "min(us)", "median(us)", "max(us)", "busy(us)", "span(us)", "gap(us)");
+
+    for (int phase_id = 0; phase_id < phaseCount(); phase_id++) {
+        TileStats stats = {0};
+        for (int w = 0; w < g_profile.num_workers; w++)
+            mergeStats(&stats, &g_profile.workers[w].tiles[phase_id]);
+        printPhaseRow(phaseName(phase_id), &stats, g_profile.span_ns[phase_id],
+                      g_profile.gap_ns[phase_id], iterations);
+        busy_ns += stats.total_ns;
+        gap_ns += g_profile.gap_ns[phase_id];
+    }
+    printPhaseRow("delta-time", &g_profile.delta, g_profile.delta.total_ns,
+                  g_profile.delta_gap_ns, iterations);
+    busy_ns += g_profile.delta.total_ns;
+
+    double iteration_s = g_profile.iteration_ns / 1.0e9;
+    double capacity_s = iteration_s * g_profile.num_workers;
+    PRINTF("Profiled iterations  = %10.6f (s)  %6.2f%% of elapsed\n", iteration_s,
+           elapsed_wall_time > 0.0 ? 100.0 * iteration_s / elapsed_wall_time : 0.0);
+    PRINTF("Critical path (est.) = %10.6f (s)  %6.2f%% of profiled\n", g_profile.critical_ns / 1.0e9,
+           iteration_s > 0.0 ? 100.0 * g_profile.critical_ns / 1.0e9 / iteration_s : 0.0);
+    PRINTF("Worker busy          = %10.6f (s)  %6.2f%% of worker time\n", busy_ns / 1.0e9,
+           capacity_s > 0.0 ? 100.0 * busy_ns / 1.0e9 / capacity_s : 0.0);
+    PRINTF("Latch gaps           = %10.6f (s)  %6.2f%% of profiled\n\n", gap_ns / 1.0e9,
+           iteration_s > 0.0 ? 100.0 * gap_ns / 1.0e9 / iteration_s : 0.0);
+}
@@ -0,0 +1,198 @@
+/******************************************************************************
+ * LULESH Tiled ARTS Version - Tile-Size Auto-Tuning
+ *
+ * One -T value is applied to all 11 tiled phases even though they range from
+ * a three-line node update to the full hourglass kernel. -T also accepts a
+ * comma-separated list with one size per phase, in graph order.
+ *
+ * -A picks that list at run time: after one warm-up iteration, each
+ * power-of-two candidate runs TUNE_REPEATS iterations at a uniform size
+ * while phaseTimerEdt stamps every phase latch. Phases 6, 7 and 10 run
+ * side by side, so a phase's time is measured from the latest of its own
+ * predecessors. The fastest candidate per phase is kept, and the graph is
+ * recaptured with those sizes.
+ ******************************************************************************/
+#include "lulesh.h"
+
+TileTuner g_tuner = {0};
+
+/*============================================================================
+ * Per-Phase Tile Sizes (-T <size>[,<size>...])
+ *============================================================================*/
+
+int parseTileSizes(const char *list) {
+    int sizes[MAX_GRAPH_PHASES];
+    int count = 0;
+    const char *p = list;
+
+    while (*p) {
+        char *end;
+        long size = strtol(p, &end, 10);
+        if (end == p || size < 1 || count == MAX_GRAPH_PHASES)
+            return -1;
+        sizes[count++] = (int)size;
+        if (*end == ',')
+            end++;
+        else if (*end != '\0')
+            return -1;
+        p = end;
+    }
+    if (count == 0)
+        return -1;
+
+    // A single size applies everywhere; a list is per phase, and phases
+    // past its end repeat the last entry
+    g_config.tile_size = sizes[0];
+    for (int i = 0; i < MAX_GRAPH_PHASES; i++)
+        g_tuner.phase_tile[i] = (count > 1) ? sizes[i < count ? i : count - 1] : 0;
+    return count;
+}
+
+int phaseTileSize(int phase_id) {
+    if (tuneTiming())
+        return g_tuner.candidates[g_tuner.trial / TUNE_REPEATS];
+    if (g_tuner.phase_tile[phase_id] > 0)
+        return g_tuner.phase_tile[phase_id];
+    return g_config.tile_size;
+}
+
+/*============================================================================
+ * Trial Schedule
+ *============================================================================*/
+
+void initTileTuner(luleshCtx *ctx) {
+    g_tuner.trial = -2;
+    g_tuner.num_candidates = 0;
+    for (int tile = TUNE_MIN_TILE; g_tuner.num_candidates < MAX_TUNE_CANDIDATES; tile *= 2) {
+        g_tuner.candidates[g_tuner.num_candidates++] = tile;
+        if (tile >= ctx->nodes)
+            break;
+    }
+    for (int i = 0; i < MAX_GRAPH_PHASES; i++)
+        g_tuner.best_ns[i] = UINT64_MAX;
+}
+
+int tuneActive(void) {
+    return g_config.auto_tune && !g_tuner.done;
+}
+
+int tuneTiming(void) {
+    return tuneActive() && g_tuner.trial >= 0;
+}
+
+static void recordTrial(const IterationGraph *graph) {
+    int tile = g_tuner.candidates[g_tuner.trial / TUNE_REPEATS];
+
+    for (int phase_id = 0; phase_id < graph->num_phases; phase_id++) {
+        const GraphPhase *phase = &graph->phases[phase_id];
+        uint64_t ready = g_tuner.start_ns;
+        for (int i = 0; i < phase->num_deps; i++) {
+            if (g_tuner.phase_end_ns[phase->deps[i]] > ready)
+                ready = g_tuner.phase_end_ns[phase->deps[i]];
+        }
+
+        uint64_t end = g_tuner.phase_end_ns[phase_id];
+        uint64_t elapsed = (end > ready) ? end - ready : 0;
+        if (elapsed < g_tuner.best_ns[phase_id]) {
+            g_tuner.best_ns[phase_id] = elapsed;
+            g_tuner.phase_tile[phase_id] = tile;
+        }
+    }
+}
+
+static void formatTileSizes(char *buf, size_t len, const IterationGraph *graph, int tuned) {
+    size_t used = 0;
+    buf[0] = '\0';
+    for (int phase_id = 0; phase_id < graph->num_phases && used < len; phase_id++) {
+        int size = tuned ? g_tuner.phase_tile[phase_id] : graph->phases[phase_id].tile_size;
+        used += snprintf(buf + used, len - used, "%s%d", phase_id ? "," : "", size);
+    }
+}
+
+// Called from startIteration before the graph is (re)captured
+void tuneBeginIteration(void) {
+    if (!tuneActive())
+        return;
+
+    uint64_t now = artsGetTimeStamp();
+    if (g_tuner.trial == -2)
+        g_tuner.first_ns = now;
+    if (g_tuner.trial >= 0)
+        recordTrial(&g_graph);
+
+    if (++g_tuner.trial == g_tuner.num_candidates * TUNE_REPEATS) {
+        g_tuner.done = 1;
+        g_tuner.tuning_ns = now - g_tuner.first_ns;
+
+        if (!g_config.quiet) {
+            char sizes[256];
+            formatTileSizes(sizes, sizeof(sizes), &g_graph, 1);
+            PRINTF("Auto-tune: phase tile sizes %s after %d iterations\n", sizes, g_tuner.iterations);
+        }
+
+        // Recapture with the chosen per-phase sizes
+        g_graph.num_phases = 0;
+        return;
+    }
+
+    g_tuner.iterations++;
+    if (g_tuner.trial >= 0 && g_tuner.trial % TUNE_REPEATS == 0)
+        g_graph.num_phases = 0;
+}
+
+/*============================================================================
+ * Timed Instantiation
+ *============================================================================*/
+
+void phaseTimerEdt(uint32_t paramc, uint64_t *paramv, uint32_t depc, artsEdtDep_t depv[]) {
+    int phase_id = (int)paramv[0];
+    artsGuid_t timedEvent = (artsGuid_t)paramv[1];
+
+    g_tuner.phase_end_ns[phase_id] = artsGetTimeStamp();
+    artsEventSatisfySlot(timedEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
+}
+
+artsGuid_t tuneTimePhase(int phase_id, artsGuid_t doneEvent) {
+    artsGuid_t timedEvent = artsEventCreate(0, 1);
+    uint64_t params[2] = {phase_id, (uint64_t)timedEvent};
+    artsGuid_t edtGuid = artsEdtCreate(phaseTimerEdt, 0, 2, params, 1);
+    artsAddDependence(doneEvent, edtGuid, 0);
+    return timedEvent;
+}
+
+// Hold phase 1 until the whole trial graph exists, so instantiation cost
+// is not charged to whichever phase happens to run first
+void instantiateTimedIteration(int iteration) {
+    artsGuid_t startEvent = artsEventCreate(0, 1);
+    instantiateIterationGraph(&g_graph, iteration, startEvent, NULL_GUID);
+    g_tuner.start_ns = artsGetTimeStamp();
+    artsEventSatisfySlot(startEvent, NULL_GUID, ARTS_EVENT_LATCH_DECR_SLOT);
+}
+
+/*============================================================================
+ * Report
+ *============================================================================*/
+
+void printTileConfig(void) {
+    char sizes[256];
+    formatTileSizes(sizes, sizeof(sizes), &g_graph, 0);
+    PRINTF("Tile sizes           = %s (per phase)\n", sizes);
+
+    if (g_config.auto_tune) {
+        int last = g_tuner.candidates[g_tuner.num_candidates - 1];
+        if (g_tuner.done) {
+            PRINTF("Auto-tune            = %10.6f (s)  %d iterations, candidates %d-%d, -T %s\n",
+                   (double)g_tuner.tuning_ns / 1.0e9, g_tuner.iterations,
+                   TUNE_MIN_TILE, last, sizes);
+        } else {
+            // The run ended mid-tuning; fold in the trial that just finished
+            if (g_tuner.trial >= 0)
+                recordTrial(&g_graph);
+            formatTileSizes(sizes, sizeof(sizes), &g_graph, 1);
+            PRINTF("Auto-tune            = incomplete after %d of %d iterations, best so far -T %s\n",
+                   g_tuner.iterations, g_tuner.num_candidates * TUNE_REPEATS + 1,
+                   g_tuner.trial >= 0 ? sizes : "-");
+        }
+    }
+    PRINTF("\n");
+}
@@ -0,0 +1,643 @@
+/******************************************************************************
+ * OCR API Microbenchmarks for the ARTS Shim (src/arts-ocr.c)
+ *
+ * Times the individual OCR operations that apps hit on their hot paths:
+ * EDT creation and spawn trees, event satisfaction for each event kind,
+ * dependence wiring, DB creation and acquisition per access mode, labeled
+ * GUID creation and finish-EDT scopes.
+ *
+ * Each benchmark issues <ops> operations from one EDT and reports:
+ *   latency     time per operation on the issuing EDT (the call's cost on
+ *               the critical path of whoever makes it)
+ *   throughput  operations per second until the work they trigger (sink
+ *               EDTs, reductions, relays) has finished on all workers
+ *   setup       untimed preparation (creating the EDTs/events to wire)
+ *
+ * Benchmarks run one after another; the issuing EDT and every sink check
+ * in on a shared counter, and the last one releases the next benchmark.
+ * The worker count comes from arts.cfg, so a thread sweep is a series of
+ * runs (scripts/run_ocr_microbench.sh).
+ *
+ * Usage: ocr_microbench [-n ops] [-b bench,...] [-s db_bytes] [-k children]
+ *                       [-c contributors] [-j]
+ ******************************************************************************/
+#define ENABLE_EXTENSION_PARAMS_EVT
+#define ENABLE_EXTENSION_COLLECTIVE_EVT
+#define ENABLE_EXTENSION_LABELING
+#define ENABLE_EXTENSION_CHANNEL_EVT
+
+#include "ocr.h"
+#include "extensions/ocr-labeling.h"
+#include "extensions/ocr-reduction-event.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_OPS 100000
+#define DEFAULT_DB_BYTES 64
+#define DEFAULT_FINISH_CHILDREN 4
+#define DEFAULT_CONTRIBUTORS 16
+
+// The shim keeps a 2048-generation window per channel; stay well inside it
+#define CHANNEL_BATCH 1024
+// The shim's collective events take at most 256 contributors
+#define MAX_CONTRIBUTORS 256
+// ocrDbDestroy is a no-op in the shim, so cap what db_create allocates
+#define DB_CREATE_MAX_BYTES (256ull << 20)
+
+typedef struct Config {
+    u64 ops;
+    u64 db_bytes;
+    u32 finish_children;
+    u32 contributors;
+    int json;
+    char selected[512];         // Comma-separated names, empty = all
+} Config;
+
+typedef struct Bench {
+    const char *name;
+    void (*run)(void);
+} Bench;
+
+// State of the running benchmark
+typedef struct BenchState {
+    int index;
+    u64 ops;
+    volatile u64 pending;       // Issuer + sinks still to check in
+    double start;               // First timed loop start (s)
+    double lap;                 // Current timed loop start (s)
+    double loop;                // Timed loop duration (s)
+    double end;                 // Last check-in (s)
+    double setup;
+    double between;             // Setup between timed loops (s), not in the total
+    int has_latency;
+    ocrGuid_t done;             // Once event: releases reportEdt
+    ocrGuid_t db;               // Shared DB for the acquire benchmarks
+    ocrDbAccessMode_t mode;
+} BenchState;
+
+static Config g_config;
+static BenchState g_state;
+
+static ocrGuid_t sinkTemplate;
+static ocrGuid_t reportTemplate;
+static ocrGuid_t treeTemplate;
+static ocrGuid_t finishTemplate;
+static ocrGuid_t finishStepTemplate;
+static ocrGuid_t childTemplate;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+/*============================================================================
+ * Completion
+ *============================================================================*/
+
+// Called by the issuer once after its timed loop and by every sink; the
+// last caller stamps the end time and starts the report
+static void checkIn(void) {
+    if (__atomic_sub_fetch(&g_state.pending, 1, __ATOMIC_ACQ_REL) == 0) {
+        g_state.end = now();
+        ocrEventSatisfy(g_state.done, NULL_GUID);
+    }
+}
+
+// Prepares g_state for a benchmark of <ops> operations and <sinks> sinks
+static void beginBench(u64 ops, u64 sinks, int has_latency) {
+    g_state.ops = ops;
+    g_state.pending = sinks + 1;
+    g_state.has_latency = has_latency;
+    g_state.start = 0.0;
+    g_state.setup = 0.0;
+    g_state.between = 0.0;
+    g_state.loop = 0.0;
+
+    ocrGuid_t report;
+    ocrEventCreate(&g_state.done, OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+    ocrEdtCreate(&report, reportTemplate, 0, NULL, 1, &g_state.done, EDT_PROP_NONE, NULL_HINT, NULL);
+}
+
+// Benchmarks that set up in batches call this once per timed loop; the
+// total runs from the first loop, less the setup done between loops
+static void startTimer(double setup_start) {
+    g_state.lap = now();
+    g_state.setup += g_state.lap - setup_start;
+    if (g_state.start == 0.0)
+        g_state.start = g_state.lap;
+    else
+        g_state.between += g_state.lap - setup_start;
+}
+
+static void stopTimer(void) {
+    g_state.loop += now() - g_state.lap;
+}
+
+ocrGuid_t sinkEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    checkIn();
+    return NULL_GUID;
+}
+
+// No check-in: the children of a finish scope are tracked by the scope
+ocrGuid_t childEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    return NULL_GUID;
+}
+
+// Sinks waiting on one dependence that the benchmark wires later
+static void createSinks(ocrGuid_t *sinks, u64 count) {
+    for (u64 i = 0; i < count; i++)
+        ocrEdtCreate(&sinks[i], sinkTemplate, 0, NULL, 1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+}
+
+/*============================================================================
+ * EDTs
+ *============================================================================*/
+
+// Create and schedule runnable EDTs as fast as one EDT can
+static void runEdtCreate(void) {
+    u64 n = g_config.ops;
+    beginBench(n, n, 1);
+
+    startTimer(now());
+    for (u64 i = 0; i < n; i++) {
+        ocrGuid_t edt;
+        ocrEdtCreate(&edt, sinkTemplate, 0, NULL, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    stopTimer();
+    checkIn();
+}
+
+// Binary spawn tree: every worker creates EDTs
+ocrGuid_t treeEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    if (paramv[0] == 0) {
+        checkIn();
+        return NULL_GUID;
+    }
+    u64 depth = paramv[0] - 1;
+    for (int i = 0; i < 2; i++) {
+        ocrGuid_t edt;
+        ocrEdtCreate(&edt, treeTemplate, 1, &depth, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    return NULL_GUID;
+}
+
+static void runEdtTree(void) {
+    u64 depth = 1;
+    while ((2ull << (depth + 1)) - 1 <= g_config.ops)
+        depth++;
+    u64 leaves = 1ull << depth;
+    beginBench((2 * leaves) - 1, leaves, 0);
+
+    startTimer(now());
+    ocrGuid_t root;
+    ocrEdtCreate(&root, treeTemplate, 1, &depth, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    stopTimer();
+    checkIn();
+}
+
+/*============================================================================
+ * Event Satisfaction
+ *============================================================================*/
+
+// One event of <type> per sink; times the satisfy calls
+static void runEventSatisfy(ocrEventTypes_t type) {
+    u64 n = g_config.ops;
+    ocrGuid_t *events = malloc(sizeof(ocrGuid_t) * n);
+    beginBench(n, n, 1);
+
+    double setup = now();
+    for (u64 i = 0; i < n; i++) {
+        ocrGuid_t sink;
+        ocrEventCreate(&events[i], type, EVT_PROP_NONE);
+        ocrEdtCreate(&sink, sinkTemplate, 0, NULL, 1, &events[i], EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+
+    startTimer(setup);
+    for (u64 i = 0; i < n; i++)
+        ocrEventSatisfy(events[i], NULL_GUID);
+    stopTimer();
+
+    free(events);
+    checkIn();
+}
+
+static void runEventOnce(void) { runEventSatisfy(OCR_EVENT_ONCE_T); }
+static void runEventSticky(void) { runEventSatisfy(OCR_EVENT_STICKY_T); }
+
+// One latch counted up <ops> times, then down; only the decrements are timed
+static void runEventLatch(void) {
+    u64 n = g_config.ops;
+    ocrGuid_t latch, sink;
+    beginBench(n, 1, 1);
+
+    double setup = now();
+    ocrEventCreate(&latch, OCR_EVENT_LATCH_T, EVT_PROP_NONE);
+    ocrEdtCreate(&sink, sinkTemplate, 0, NULL, 1, &latch, EDT_PROP_NONE, NULL_HINT, NULL);
+    for (u64 i = 0; i < n; i++)
+        ocrEventSatisfySlot(latch, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+
+    startTimer(setup);
+    for (u64 i = 0; i < n; i++)
+        ocrEventSatisfySlot(latch, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    stopTimer();
+    checkIn();
+}
+
+// One channel: consumers are attached in batches, then the batch is produced
+static void runEventChannel(void) {
+    u64 n = g_config.ops;
+    ocrGuid_t channel;
+    ocrGuid_t sinks[CHANNEL_BATCH];
+    ocrEventParams_t params;
+    beginBench(n, n, 1);
+
+    double setup = now();
+    memset(&params, 0, sizeof(params));
+    params.EVENT_CHANNEL.maxGen = CHANNEL_BATCH;
+    params.EVENT_CHANNEL.nbSat = 1;
+    params.EVENT_CHANNEL.nbDeps = 1;
+    ocrEventCreateParams(&channel, OCR_EVENT_CHANNEL_T, EVT_PROP_NONE, &params);
+
+    for (u64 base = 0; base < n; base += CHANNEL_BATCH) {
+        u64 count = (n - base < CHANNEL_BATCH) ? n - base : CHANNEL_BATCH;
+        if (base > 0)
+            setup = now();
+        createSinks(sinks, count);
+        for (u64 i = 0; i < count; i++)
+            ocrAddDependence(channel, sinks[i], 0, DB_DEFAULT_MODE);
+
+        startTimer(setup);
+        for (u64 i = 0; i < count; i++)
+            ocrEventSatisfy(channel, NULL_GUID);
+        stopTimer();
+    }
+    checkIn();
+}
+
+// All-reduce over -c contributions per generation; times the contributions
+static void runEventCollective(void) {
+    u32 contributors = g_config.contributors;
+    u64 generations = (g_config.ops + contributors - 1) / contributors;
+    ocrGuid_t collective;
+    ocrEventParams_t params;
+    beginBench(generations * contributors, generations, 1);
+
+    double setup = now();
+    memset(&params, 0, sizeof(params));
+    params.EVENT_COLLECTIVE.nbContribs = contributors;
+    params.EVENT_COLLECTIVE.nbDatum = 1;
+    params.EVENT_COLLECTIVE.op = REDOP_F8_ADD;
+    params.EVENT_COLLECTIVE.type = COL_ALLREDUCE;
+    ocrEventCreateParams(&collective, OCR_EVENT_COLLECTIVE_T, EVT_PROP_NONE, &params);
+
+    for (u64 gen = 0; gen < generations; gen++) {
+        ocrGuid_t sink;
+        double value = 1.0;
+        if (gen > 0)
+            setup = now();
+        createSinks(&sink, 1);
+        ocrAddDependenceSlot(collective, 0, sink, 0, DB_MODE_RO);
+
+        startTimer(setup);
+        for (u32 slot = 0; slot < contributors; slot++)
+            ocrEventCollectiveSatisfySlot(collective, &value, slot);
+        stopTimer();
+    }
+    checkIn();
+}
+
+/*============================================================================
+ * Dependence Wiring
+ *============================================================================*/
+
+// Unsatisfied sticky event -> <ops> EDTs, released after the timed loop
+static void runDepsEventEdt(void) {
+    u64 n = g_config.ops;
+    ocrGuid_t source;
+    ocrGuid_t *sinks = malloc(sizeof(ocrGuid_t) * n);
+    beginBench(n, n, 1);
+
+    double setup = now();
+    ocrEventCreate(&source, OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+    createSinks(sinks, n);
+
+    startTimer(setup);
+    for (u64 i = 0; i < n; i++)
+        ocrAddDependence(source, sinks[i], 0, DB_DEFAULT_MODE);
+    stopTimer();
+
+    ocrEventSatisfy(source, NULL_GUID);
+    free(sinks);
+    checkIn();
+}
+
+// Unsatisfied sticky event -> <ops> once events (the shim's relay-EDT path)
+static void runDepsEventEvent(void) {
+    u64 n = g_config.ops;
+    ocrGuid_t source;
+    ocrGuid_t *events = malloc(sizeof(ocrGuid_t) * n);
+    beginBench(n, n, 1);
+
+    double setup = now();
+    ocrEventCreate(&source, OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+    for (u64 i = 0; i < n; i++) {
+        ocrGuid_t sink;
+        ocrEventCreate(&events[i], OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+        ocrEdtCreate(&sink, sinkTemplate, 0, NULL, 1, &events[i], EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+
+    startTimer(setup);
+    for (u64 i = 0; i < n; i++)
+        ocrAddDependence(source, events[i], 0, DB_DEFAULT_MODE);
+    stopTimer();
+
+    ocrEventSatisfy(source, NULL_GUID);
+    free(events);
+    checkIn();
+}
+
+/*============================================================================
+ * Data Blocks
+ *============================================================================*/
+
+static void runDbCreate(void) {
+    u64 n = g_config.ops;
+    if (n * g_config.db_bytes > DB_CREATE_MAX_BYTES)
+        n = DB_CREATE_MAX_BYTES / g_config.db_bytes;
+    beginBench(n, 0, 1);
+
+    startTimer(now());
+    for (u64 i = 0; i < n; i++) {
+        ocrGuid_t db;
+        void *ptr;
+        ocrDbCreate(&db, &ptr, g_config.db_bytes, DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    }
+    stopTimer();
+    checkIn();
+}
+
+// One DB acquired by <ops> EDTs in the given mode; times the wiring, and
+// throughput covers the acquisitions
+static void runDbAcquire(ocrDbAccessMode_t mode) {
+    u64 n = g_config.ops;
+    ocrGuid_t *sinks = malloc(sizeof(ocrGuid_t) * n);
+    void *ptr;
+    beginBench(n, n, 1);
+
+    double setup = now();
+    ocrDbCreate(&g_state.db, &ptr, g_config.db_bytes, DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    memset(ptr, 0, g_config.db_bytes);
+    ocrDbRelease(g_state.db);
+    createSinks(sinks, n);
+
+    startTimer(setup);
+    for (u64 i = 0; i < n; i++)
+        ocrAddDependence(g_state.db, sinks[i], 0, mode);
+    stopTimer();
+
+    free(sinks);
+    checkIn();
+}
+
+static void runDbAcquireRo(void) { runDbAcquire(DB_MODE_RO); }
+static void runDbAcquireRw(void) { runDbAcquire(DB_MODE_RW); }
+static void runDbAcquireEw(void) { runDbAcquire(DB_MODE_EW); }
+static void runDbAcquireConst(void) { runDbAcquire(DB_MODE_CONST); }
+
+/*============================================================================
+ * Labeled GUIDs
+ *============================================================================*/
+
+// Sticky events from a labeled range; the second pass hits existing GUIDs
+static void runLabeled(int existing) {
+    u64 n = g_config.ops;
+    ocrGuid_t range;
+    beginBench(n, 0, 1);
+
+    double setup = now();
+    ocrGuidRangeCreate(&range, n, GUID_USER_EVENT_STICKY);
+    if (existing) {
+        for (u64 i = 0; i < n; i++) {
+            ocrGuid_t event;
+            ocrGuidFromIndex(&event, range, i);
+            ocrEventCreate(&event, OCR_EVENT_STICKY_T, GUID_PROP_IS_LABELED);
+        }
+    }
+
+    startTimer(setup);
+    for (u64 i = 0; i < n; i++) {
+        ocrGuid_t event;
+        ocrGuidFromIndex(&event, range, i);
+        ocrEventCreate(&event, OCR_EVENT_STICKY_T, GUID_PROP_IS_LABELED | GUID_PROP_CHECK);
+    }
+    stopTimer();
+    checkIn();
+}
+
+static void runLabeledCreate(void) { runLabeled(0); }
+static void runLabeledExisting(void) { runLabeled(1); }
+
+/*============================================================================
+ * Finish Scopes
+ *============================================================================*/
+
+ocrGuid_t finishEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    for (u32 i = 0; i < g_config.finish_children; i++) {
+        ocrGuid_t child;
+        ocrEdtCreate(&child, childTemplate, 0, NULL, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    return NULL_GUID;
+}
+
+// Step <i> of a chain: opens finish scope i and waits for it to close
+ocrGuid_t finishStepEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 step = paramv[0];
+    if (step == g_state.ops) {
+        checkIn();
+        return NULL_GUID;
+    }
+
+    ocrGuid_t scope, scopeDone, next;
+    u64 nextStep = step + 1;
+    ocrEdtCreate(&scope, finishTemplate, 0, NULL, 0, NULL, EDT_PROP_FINISH, NULL_HINT, &scopeDone);
+    ocrEdtCreate(&next, finishStepTemplate, 1, &nextStep, 1, &scopeDone, EDT_PROP_NONE, NULL_HINT, NULL);
+    return NULL_GUID;
+}
+
+// Scopes run back to back, so latency here is the time per scope
+static void runFinishScope(void) {
+    u64 scopes = g_config.ops / (g_config.finish_children + 1);
+    u64 step = 0;
+    if (scopes == 0)
+        scopes = 1;
+    beginBench(scopes, 1, 0);
+
+    startTimer(now());
+    ocrGuid_t first;
+    ocrEdtCreate(&first, finishStepTemplate, 1, &step, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    stopTimer();
+    checkIn();
+}
+
+/*============================================================================
+ * Driver
+ *============================================================================*/
+
+static const Bench benches[] = {
+    {"edt_create",         runEdtCreate},
+    {"edt_tree",           runEdtTree},
+    {"event_once",         runEventOnce},
+    {"event_sticky",       runEventSticky},
+    {"event_latch",        runEventLatch},
+    {"event_channel",      runEventChannel},
+    {"event_collective",   runEventCollective},
+    {"deps_event_edt",     runDepsEventEdt},
+    {"deps_event_event",   runDepsEventEvent},
+    {"db_create",          runDbCreate},
+    {"db_acquire_ro",      runDbAcquireRo},
+    {"db_acquire_rw",      runDbAcquireRw},
+    {"db_acquire_ew",      runDbAcquireEw},
+    {"db_acquire_const",   runDbAcquireConst},
+    {"labeled_create",     runLabeledCreate},
+    {"labeled_existing",   runLabeledExisting},
+    {"finish_scope",       runFinishScope},
+};
+
+#define NUM_BENCHES ((int)(sizeof(benches) / sizeof(benches[0])))
+
+static int isSelected(const char *name) {
+    if (g_config.selected[0] == '\0')
+        return 1;
+    size_t len = strlen(name);
+    for (const char *p = g_config.selected; (p = strstr(p, name)) != NULL; p += len) {
+        if ((p == g_config.selected || p[-1] == ',') && (p[len] == ',' || p[len] == '\0'))
+            return 1;
+    }
+    return 0;
+}
+
+// Runs the next selected benchmark after <index>, or shuts down
+static void startNext(int index) {
+    while (++index < NUM_BENCHES && !isSelected(benches[index].name))
+        ;
+    if (index == NUM_BENCHES) {
+        if (!g_config.json)
+            PRINTF("\n");
+        ocrShutdown();
+        return;
+    }
+    g_state.index = index;
+    benches[index].run();
+}
+
+ocrGuid_t reportEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    const char *name = benches[g_state.index].name;
+    double total = g_state.end - g_state.start - g_state.between;
+    double latency_ns = g_state.loop * 1.0e9 / g_state.ops;
+    double mops = total > 0.0 ? g_state.ops / total / 1.0e6 : 0.0;
+
+    if (g_config.json) {
+        char latency[32];
+        if (g_state.has_latency)
+            snprintf(latency, sizeof(latency), "%.1f", latency_ns);
+        else
+            snprintf(latency, sizeof(latency), "null");
+        PRINTF("{\"bench\":\"%s\",\"ops\":%llu,\"latency_ns\":%s,\"throughput_mops\":%.4f,"
+               "\"total_s\":%.6f,\"setup_s\":%.6f}\n",
+               name, (unsigned long long)g_state.ops, latency, mops, total, g_state.setup);
+    } else if (g_state.has_latency) {
+        PRINTF("%-20s %10llu %12.1f %14.4f %10.4f %10.4f\n", name, (unsigned long long)g_state.ops,
+               latency_ns, mops, total, g_state.setup);
+    } else {
+        PRINTF("%-20s %10llu %12s %14.4f %10.4f %10.4f\n", name, (unsigned long long)g_state.ops,
+               "-", mops, total, g_state.setup);
+    }
+
+    startNext(g_state.index);
+    return NULL_GUID;
+}
+
+static void usage(void) {
+    PRINTF("Usage: ocr_microbench [options]\n");
+    PRINTF("  -n <ops>       Operations per benchmark (default: %d)\n", DEFAULT_OPS);
+    PRINTF("  -b <names>     Comma-separated benchmarks (default: all)\n");
+    PRINTF("  -s <bytes>     DB size for db_create/db_acquire_* (default: %d)\n", DEFAULT_DB_BYTES);
+    PRINTF("  -k <children>  Child EDTs per finish scope (default: %d)\n", DEFAULT_FINISH_CHILDREN);
+    PRINTF("  -c <count>     Contributors per collective generation (default: %d, max %d)\n",
+           DEFAULT_CONTRIBUTORS, MAX_CONTRIBUTORS);
+    PRINTF("  -j             One JSON object per benchmark instead of a table\n");
+    PRINTF("Benchmarks:");
+    for (int i = 0; i < NUM_BENCHES; i++)
+        PRINTF(" %s", benches[i].name);
+    PRINTF("\n");
+}
+
+static int parseArgs(void *argsDb) {
+    u64 argc = getArgc(argsDb);
+
+    g_config.ops = DEFAULT_OPS;
+    g_config.db_bytes = DEFAULT_DB_BYTES;
+    g_config.finish_children = DEFAULT_FINISH_CHILDREN;
+    g_config.contributors = DEFAULT_CONTRIBUTORS;
+    g_config.json = 0;
+    g_config.selected[0] = '\0';
+
+    for (u64 i = 1; i < argc; i++) {
+        const char *arg = getArgv(argsDb, i);
+        const char *value = (i + 1 < argc) ? getArgv(argsDb, i + 1) : NULL;
+
+        if (strcmp(arg, "-j") == 0) {
+            g_config.json = 1;
+            continue;
+        }
+        if (!value)
+            return 0;
+        if (strcmp(arg, "-n") == 0) {
+            g_config.ops = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "-b") == 0) {
+            snprintf(g_config.selected, sizeof(g_config.selected), "%s", value);
+        } else if (strcmp(arg, "-s") == 0) {
+            g_config.db_bytes = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "-k") == 0) {
+            g_config.finish_children = (u32)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "-c") == 0) {
+            g_config.contributors = (u32)strtoul(value, NULL, 10);
+        } else {
+            return 0;
+        }
+        i++;
+    }
+
+    return g_config.ops > 0 && g_config.db_bytes > 0 &&
+           g_config.contributors > 0 && g_config.contributors <= MAX_CONTRIBUTORS;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    if (!parseArgs(depv[0].ptr)) {
+        usage();
+        ocrShutdown();
+        return NULL_GUID;
+    }
+
+    ocrEdtTemplateCreate(&sinkTemplate, sinkEdt, 0, EDT_PARAM_UNK);
+    ocrEdtTemplateCreate(&reportTemplate, reportEdt, 0, 1);
+    ocrEdtTemplateCreate(&treeTemplate, treeEdt, 1, 0);
+    ocrEdtTemplateCreate(&finishTemplate, finishEdt, 0, 0);
+    ocrEdtTemplateCreate(&finishStepTemplate, finishStepEdt, 1, EDT_PARAM_UNK);
+    ocrEdtTemplateCreate(&childTemplate, childEdt, 0, 0);
+
+    if (!g_config.json) {
+        PRINTF("OCR microbenchmarks: %llu ops, %llu-byte DBs, %u children per finish scope, "
+               "%u contributors per collective\n\n", (unsigned long long)g_config.ops,
+               (unsigned long long)g_config.db_bytes, g_config.finish_children, g_config.contributors);
+        PRINTF("%-20s %10s %12s %14s %10s %10s\n", "benchmark", "ops", "latency(ns)",
+               "throughput(M/s)", "total(s)", "setup(s)");
+    }
+
+    startNext(-1);
+    return NULL_GUID;
+}
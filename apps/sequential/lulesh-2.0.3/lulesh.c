@@ -26,6 +26,9 @@ static void print_usage(const char *progname) {
            DEFAULT_EDGE_ELEMENTS, MAX_EDGE_ELEMENTS);
     printf("  -i <iter>    Maximum iterations (default: %d)\n", DEFAULT_MAX_ITERATIONS);
     printf("  -t <time>    Stop time (default: 1.0e-2)\n");
+#ifdef _OPENMP
+    printf("  -n <threads> Worker threads (default: OMP_NUM_THREADS or all cores)\n");
+#endif
     printf("  -p           Show iteration progress\n");
     printf("  -q           Quiet mode (minimal output)\n");
     printf("  -h           Show this help message\n");
@@ -40,10 +43,11 @@ static void parse_command_line(int argc, char **argv, RuntimeConfig *config) {
     config->stop_time = 1.0e-2;
     config->show_progress = 0;
     config->quiet = 0;
+    config->num_threads = omp_get_max_threads();
     
     optind = 1;
     
-    while ((opt = getopt(argc, argv, "s:i:t:pqh")) != -1) {
+    while ((opt = getopt(argc, argv, "s:i:t:n:pqh")) != -1) {
         switch (opt) {
             case 's':
                 config->edge_elements = atoi(optarg);
@@ -70,6 +74,17 @@ static void parse_command_line(int argc, char **argv, RuntimeConfig *config) {
                     config->stop_time = 1.0e-2;
                 }
                 break;
+            case 'n':
+#ifdef _OPENMP
+                config->num_threads = atoi(optarg);
+                if (config->num_threads < 1) {
+                    fprintf(stderr, "Error: thread count must be at least 1\n");
+                    config->num_threads = omp_get_max_threads();
+                }
+#else
+                fprintf(stderr, "Error: -n requires the threaded build, ignoring\n");
+#endif
+                break;
             case 'p':
                 config->show_progress = 1;
                 break;
@@ -85,6 +100,10 @@ static void parse_command_line(int argc, char **argv, RuntimeConfig *config) {
         }
     }
     
+#ifdef _OPENMP
+    omp_set_num_threads(config->num_threads);
+#endif
+    
     // Compute derived values
     config->edge_nodes = config->edge_elements + 1;
     config->num_nodes = config->edge_nodes * config->edge_nodes * config->edge_nodes;
@@ -122,18 +141,6 @@ static void free_2d_int(int **arr) {
  * Domain Initialization
  *============================================================================*/
 
-static double my_cbrt(double x) {
-    if (x == 0.0) return 0.0;
-    double ans = 1.0, old = 0.0;
-    int iter = 0;
-    while (fabs(old - ans) >= 1.0e-10 && iter < 100) {
-        old = ans;
-        ans = (x / (ans * ans) + 2.0 * ans) / 3.0;
-        iter++;
-    }
-    return ans;
-}
-
 void initialize_domain(RuntimeConfig *config, Domain *dom,
                        Constraints *constraints, Constants *constants, Cutoffs *cutoffs) {
     int edge_elements = config->edge_elements;
@@ -197,6 +204,10 @@ void initialize_domain(RuntimeConfig *config, Domain *dom,
     dom->position_gradient = (vector *)calloc(num_elements, sizeof(vector));
     dom->velocity_gradient = (vector *)calloc(num_elements, sizeof(vector));
     
+    // Allocate per-thread reduction slots
+    dom->thread_courant = (double *)malloc(config->num_threads * sizeof(double));
+    dom->thread_hydro = (double *)malloc(config->num_threads * sizeof(double));
+    
     // Allocate mesh connectivity
     dom->nodes_node_neighbors = alloc_2d_int(num_nodes, 6);
     dom->nodes_element_neighbors = alloc_2d_int(num_nodes, 8);
@@ -362,6 +373,10 @@ void free_domain(RuntimeConfig *config, Domain *dom) {
     free(dom->position_gradient);
     free(dom->velocity_gradient);
     
+    // Free per-thread reduction slots
+    free(dom->thread_courant);
+    free(dom->thread_hydro);
+    
     // Free mesh connectivity
     free_2d_int(dom->nodes_node_neighbors);
     free_2d_int(dom->nodes_element_neighbors);
@@ -433,7 +448,7 @@ void run_lulesh(RuntimeConfig *config) {
     
     if (!config->quiet) {
         printf("Running problem size %d^3 per domain until completion\n", config->edge_elements);
-        printf("Num processors: 1\n");
+        printf("Num processors: %d\n", config->num_threads);
         printf("Total number of elements: %d\n\n", config->num_elements);
         printf("To run other sizes, use -s <integer>.\n");
         printf("To run a fixed number of iterations, use -i <integer>.\n");
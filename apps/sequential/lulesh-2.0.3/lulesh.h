@@ -1,6 +1,10 @@
 /******************************************************************************
  * LULESH 2.0.3 - Sequential Version
  * Pure C implementation with no parallelization (no OpenMP, pthread, ARTS, OCR)
+ *
+ * The same sources also build lulesh_sequential_threaded with -fopenmp: each
+ * phase loop is split statically across threads, and the delta-time
+ * reduction combines per-thread partials in thread order.
  ******************************************************************************/
 #ifndef LULESH_SEQUENTIAL_H
 #define LULESH_SEQUENTIAL_H
@@ -12,6 +16,14 @@
 #include <stdint.h>
 #include <sys/time.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#else
+static inline int omp_get_thread_num(void) { return 0; }
+static inline int omp_get_num_threads(void) { return 1; }
+static inline int omp_get_max_threads(void) { return 1; }
+#endif
+
 /*============================================================================
  * Configuration
  *============================================================================*/
@@ -40,6 +52,7 @@ typedef struct RuntimeConfig {
     double stop_time;
     int show_progress;
     int quiet;
+    int num_threads;
 } RuntimeConfig;
 
 /*============================================================================
@@ -128,6 +141,10 @@ typedef struct Domain {
     vector *position_gradient;
     vector *velocity_gradient;
     
+    // Per-thread partial minima for the delta time reduction
+    double *thread_courant;  // [num_threads]
+    double *thread_hydro;    // [num_threads]
+    
     // Global time
     double delta_time;
     double elapsed_time;
@@ -186,6 +203,42 @@ static inline vector cross(vector a, vector b) {
     };
 }
 
+// Cube root with a fixed operation count, so element loops that call it
+// vectorize. The guess divides the high word of the exponent by 3 (fdlibm's
+// constant, within 3.2%); two Halley steps and one Newton step bring it to
+// within 3 ulp of cbrt(). Build with -DLULESH_NEWTON_CBRT for the original
+// Newton loop (for TG compatibility) when comparing results.
+#ifndef LULESH_NEWTON_CBRT
+static inline double my_cbrt(double x) {
+    double ax = fabs(x);
+    uint64_t bits;
+    memcpy(&bits, &ax, sizeof(bits));
+    bits = (uint64_t)((uint32_t)(bits >> 32) / 3 + 0x2a9f7893u) << 32;
+    double y;
+    memcpy(&y, &bits, sizeof(y));
+
+    double y3 = y * y * y;
+    y = y * (y3 + 2.0 * ax) / (2.0 * y3 + ax);
+    y3 = y * y * y;
+    y = y * (y3 + 2.0 * ax) / (2.0 * y3 + ax);
+    y = y - (y * y * y - ax) / (3.0 * y * y);
+
+    return (x == 0.0) ? 0.0 : copysign(y, x);
+}
+#else
+static inline double my_cbrt(double x) {
+    if (x == 0.0) return 0.0;
+    double ans = 1.0, old = 0.0;
+    int iter = 0;
+    while (fabs(old - ans) >= 1.0e-10 && iter < 100) {
+        old = ans;
+        ans = (x / (ans * ans) + 2.0 * ans) / 3.0;
+        iter++;
+    }
+    return ans;
+}
+#endif
+
 /*============================================================================
  * Timing Helper
  *============================================================================*/
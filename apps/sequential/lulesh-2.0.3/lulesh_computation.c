@@ -15,18 +15,6 @@
  * Helper Functions
  *============================================================================*/
 
-static inline double my_cbrt(double x) {
-    if (x == 0.0) return 0.0;
-    double ans = 1.0, old = 0.0;
-    int iter = 0;
-    while (fabs(old - ans) >= 1.0e-10 && iter < 100) {
-        old = ans;
-        ans = (x / (ans * ans) + 2.0 * ans) / 3.0;
-        iter++;
-    }
-    return ans;
-}
-
 static inline int calc_map_id(int node_id, int local_element_id) {
     return (node_id << 3) | local_element_id;
 }
@@ -227,6 +215,9 @@ static void compute_hourglass_partial_for_element(RuntimeConfig *config, Domain
 }
 
 void compute_stress_and_hourglass(RuntimeConfig *config, Domain *dom, Constants *constants) {
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
     for (int element_id = 0; element_id < config->num_elements; element_id++) {
         compute_stress_partial_for_element(config, dom, constants, element_id);
         compute_hourglass_partial_for_element(config, dom, constants, element_id);
@@ -295,6 +286,9 @@ static void compute_position_for_node(RuntimeConfig *config, Domain *dom,
 void compute_force_velocity_position(RuntimeConfig *config, Domain *dom, Cutoffs *cutoffs) {
     double dt = dom->delta_time;
     
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
     for (int node_id = 0; node_id < config->num_nodes; node_id++) {
         reduce_force_for_node(config, dom, node_id);
         compute_velocity_for_node(config, dom, cutoffs, node_id, dt);
@@ -544,6 +538,9 @@ static void compute_char_length_for_element(RuntimeConfig *config, Domain *dom,
 void compute_volume_and_gradients(RuntimeConfig *config, Domain *dom, Cutoffs *cutoffs) {
     double dt = dom->delta_time;
     
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
     for (int element_id = 0; element_id < config->num_elements; element_id++) {
         compute_volume_for_element(config, dom, cutoffs, element_id);
         compute_volume_derivative_for_element(config, dom, element_id, dt);
@@ -835,6 +832,9 @@ static void compute_time_constraints_for_element(RuntimeConfig *config, Domain *
 
 void compute_viscosity_and_energy(RuntimeConfig *config, Domain *dom,
                                   Constants *constants, Cutoffs *cutoffs) {
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
     for (int element_id = 0; element_id < config->num_elements; element_id++) {
         compute_viscosity_terms_for_element(config, dom, constants, element_id);
         compute_energy_for_element(config, dom, constants, cutoffs, element_id);
@@ -850,16 +850,48 @@ void compute_time_constraints(RuntimeConfig *config, Domain *dom,
                               Constants *constants, Constraints *constraints) {
     double prev_dt = dom->delta_time;
     
-    // Find minimum courant and hydro constraints
+    // Find minimum courant and hydro constraints: each thread reduces a
+    // fixed contiguous chunk, partials are combined in thread order
+    int num_threads = 1;
+    
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+        int tid = omp_get_thread_num();
+        int nthreads = omp_get_num_threads();
+        int chunk = (config->num_elements + nthreads - 1) / nthreads;
+        int start = tid * chunk;
+        int end = start + chunk;
+        if (end > config->num_elements) end = config->num_elements;
+        
+        double local_courant = 1.0e+20;
+        double local_hydro = 1.0e+20;
+        
+        for (int element_id = start; element_id < end; element_id++) {
+            if (dom->courant[element_id] < local_courant) {
+                local_courant = dom->courant[element_id];
+            }
+            if (dom->hydro[element_id] < local_hydro) {
+                local_hydro = dom->hydro[element_id];
+            }
+        }
+        
+        dom->thread_courant[tid] = local_courant;
+        dom->thread_hydro[tid] = local_hydro;
+        
+        if (tid == 0) num_threads = nthreads;
+    }
+    
     double min_courant = 1.0e+20;
     double min_hydro = 1.0e+20;
     
-    for (int element_id = 0; element_id < config->num_elements; element_id++) {
-        if (dom->courant[element_id] < min_courant) {
-            min_courant = dom->courant[element_id];
+    for (int tid = 0; tid < num_threads; tid++) {
+        if (dom->thread_courant[tid] < min_courant) {
+            min_courant = dom->thread_courant[tid];
         }
-        if (dom->hydro[element_id] < min_hydro) {
-            min_hydro = dom->hydro[element_id];
+        if (dom->thread_hydro[tid] < min_hydro) {
+            min_hydro = dom->thread_hydro[tid];
         }
     }
     
@@ -3,3 +3,4 @@
 #define ENABLE_EXTENSION_CHANNEL_EVT
 #define ENABLE_EXTENSION_LABELING
 #define ENABLE_EXTENSION_DEBUG
+#define ENABLE_EXTENSION_DB_ALLOCATORS
@@ -130,6 +130,11 @@ typedef u8 bool;
  */
 typedef enum {
     NO_ALLOC = 0 /**< No allocation is possible with the data block */
+#ifdef ENABLE_EXTENSION_DB_ALLOCATORS
+    , SCALABLE_ALLOC = 1 /**< TBB fixed_pool over the data block */
+    , SIMPLE_ALLOC = 2 /**< First fit, one lock per data block */
+    , SLAB_ALLOC = 3 /**< Size classes with per-thread slabs, first fit for large blocks */
+#endif
 } ocrInDbAllocator_t;
 
 /**
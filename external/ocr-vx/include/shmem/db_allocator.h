@@ -8,6 +8,9 @@
 #define OCR_TBB_db_allocator_H_GUARD
 
 #include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <new>
 
 namespace ocr_tbb
 {
@@ -84,9 +87,9 @@ namespace ocr_tbb
 					void* res = buffer_ + header_size + off;
 					off += header_size + size;
 					block_size -= header_size + size;
-					if (block_size > 0)
+					if (off < size_)
 					{
-						//if we chop the block, we still have some space left
+						//the rest of the block stays free, even if only its header fits (defragmentation merges it later)
 						ref<char>(off) = 0;
 						ref<offset_t>(off + 1) = (offset_t)block_size;
 					}
@@ -105,6 +108,155 @@ namespace ocr_tbb
 		std::size_t size_;
 		mutex_t mutex_;
 	};
+
+	/*
+	size classes with per-thread slabs for small blocks, first fit (db_allocator) for large blocks and for the slabs themselves
+	A slab holds slots of one size class and belongs to the thread that took it; that thread allocates and frees its slots without synchronization.
+	Slots freed by other threads go to the slab's remote list, a lock-free stack that the owner takes over as a whole once its own list is empty.
+	So the lock of the first-fit allocator is only taken for large blocks and when a thread needs a new slab.
+	Every block starts with an 8-byte tag: odd tags are the offset of the slab plus one (slabs are 64-byte aligned),
+	even tags belong to blocks from the first-fit allocator and hold twice the padding used to align them to 8 bytes.
+	Slabs stay with their size class while the DB lives.
+	*/
+	struct db_slab_allocator
+	{
+		db_slab_allocator(void* buffer, std::size_t size) : buffer_((char*)buffer), large_(buffer, size) {}
+		void* malloc(std::size_t size)
+		{
+			std::size_t cls = size_class(size);
+			if (cls < class_count)
+			{
+				char* block = caches_.local().take(*this, cls);
+				if (block) return block + tag_size;
+			}
+			//large block, or no room for another slab
+			char* mem = (char*)large_.malloc(size + tag_size + 7);
+			if (!mem) return 0;
+			char* block = (char*)(((uintptr_t)mem + 7) & ~(uintptr_t)7);
+			*(u64*)block = (u64)(block - mem) * 2;
+			return block + tag_size;
+		}
+		void free(void* ptr)
+		{
+			if (!ptr) return;
+			char* block = (char*)ptr - tag_size;
+			u64 tag = *(u64*)block;
+			if ((tag & 1) == 0)
+			{
+				large_.free(block - tag / 2);
+				return;
+			}
+			slab* s = (slab*)(buffer_ + (tag - 1));
+			free_slot* f = (free_slot*)block;
+			if (s->owner_ == &caches_.local())
+			{
+				f->next = s->local_free_;
+				s->local_free_ = f;
+				return;
+			}
+			free_slot* head = s->remote_free_.load(std::memory_order_relaxed);
+			do
+			{
+				f->next = head;
+			} while (!s->remote_free_.compare_exchange_weak(head, f, std::memory_order_release, std::memory_order_relaxed));
+		}
+	private:
+		static const std::size_t tag_size = sizeof(u64);
+		static const std::size_t slab_size = 16384;
+		static const std::size_t class_count = 12;
+		static std::size_t slot_size(std::size_t cls)
+		{
+			static const std::size_t sizes[class_count] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+			return sizes[cls];
+		}
+		static std::size_t size_class(std::size_t size)
+		{
+			for (std::size_t cls = 0; cls < class_count; ++cls)
+			{
+				if (size + tag_size <= slot_size(cls)) return cls;
+			}
+			return class_count;
+		}
+		struct free_slot
+		{
+			free_slot* next;
+		};
+		struct thread_cache;
+		//placed at the start of the slab memory, followed by the slots
+		struct slab
+		{
+			slab(thread_cache* owner, std::size_t slot_size, char* end) : owner_(owner), next_(0), slot_size_(slot_size), unused_((char*)this + sizeof(slab)), end_(end), local_free_(0), remote_free_(0) {}
+			//owner only; takes a freed slot, or one that was never used
+			char* take()
+			{
+				if (!local_free_) local_free_ = remote_free_.exchange(0, std::memory_order_acquire);
+				if (local_free_)
+				{
+					free_slot* f = local_free_;
+					local_free_ = f->next;
+					return (char*)f;
+				}
+				if (unused_ + slot_size_ > end_) return 0;
+				char* res = unused_;
+				unused_ += slot_size_;
+				return res;
+			}
+			thread_cache* owner_;
+			slab* next_;
+			std::size_t slot_size_;
+			char* unused_;
+			char* end_;
+			free_slot* local_free_;
+			//written by other threads, keep it away from the owner's fields
+			alignas(64) std::atomic<free_slot*> remote_free_;
+		};
+		struct thread_cache
+		{
+			thread_cache()
+			{
+				for (std::size_t i = 0; i < class_count; ++i)
+				{
+					current_[i] = 0;
+					slabs_[i] = 0;
+				}
+			}
+			char* take(db_slab_allocator& parent, std::size_t cls)
+			{
+				char* block = current_[cls] ? current_[cls]->take() : 0;
+				//the current slab is exhausted; other slabs of the class may have got some slots back in the meantime
+				for (slab* s = slabs_[cls]; !block && s; s = s->next_)
+				{
+					if (s == current_[cls]) continue;
+					block = s->take();
+					if (block) current_[cls] = s;
+				}
+				if (!block)
+				{
+					slab* s = parent.new_slab(this, cls);
+					if (!s) return 0;
+					s->next_ = slabs_[cls];
+					slabs_[cls] = s;
+					current_[cls] = s;
+					block = s->take();
+				}
+				*(u64*)block = (u64)((char*)current_[cls] - parent.buffer_) + 1;
+				return block;
+			}
+			slab* current_[class_count];
+			slab* slabs_[class_count];//all slabs of this thread, per size class
+		};
+		slab* new_slab(thread_cache* owner, std::size_t cls)
+		{
+			//the first-fit allocator does not align its blocks, leave room to align the slab header
+			char* mem = (char*)large_.malloc(slab_size + 64);
+			if (!mem) return 0;
+			char* start = (char*)(((uintptr_t)mem + 63) & ~(uintptr_t)63);
+			return new (start) slab(owner, slot_size(cls), start + slab_size);
+		}
+		char* buffer_;
+		db_allocator large_;
+		tbb::enumerable_thread_specific<thread_cache> caches_;
+	};
 }
 
 #endif
@@ -37,6 +37,8 @@
 
 #include "ocr_tbb_logging.h"
 #include "ocr_tbb_memory.h"
+#include "ocr_tbb_small_vector.h"
+#include "ocr_tbb_huge_pages.h"
 #include "ocr_tbb_tasking.h"
 #include "ocr_tbb_guided.h"
 #include "ocr_tbb_db.h"
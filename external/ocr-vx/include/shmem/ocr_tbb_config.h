@@ -9,6 +9,7 @@
 
 /* Configuration file for OCR-Vsm
 Note that some configuration options are exclusive, like ALLOCATOR_STD and ALLOCATOR_TBB.
+Some of the options are only defaults that can be changed when the program starts, see ocr_tbb_options.h.
 */
 
 //Some basic checking, whether DBs are managed properly. Should not be necesssary any more.
@@ -21,8 +22,44 @@ Note that some configuration options are exclusive, like ALLOCATOR_STD and ALLOC
 #define SCHEDULER_TBB 0
 
 //Use the custom scheduler to run tasks. 1: single-threaded FIFO scheduler; 2: task-stealing scheduler; 3: task-stealing scheduler with stealing across NUMA nodes
+//4: as 2, but each worker has a Chase-Lev deque (owner LIFO, thieves FIFO) instead of a concurrent queue; NUMA-node queues take affinity spawns and deque overflow; 5: as 4, with stealing across NUMA nodes
+//The worker queue type is compiled in, so --ocr:scheduler-int only switches between 2 and 3 or between 4 and 5
 #define SCHEDULER_INT 1
 
+//Capacity of the per-worker deques of SCHEDULER_INT 4 and 5 (power of two); when a deque is full, new tasks go to the shared queue
+#define WORKER_DEQUE_CAPACITY 4096
+
+//Victim selection of the task-stealing schedulers. 0: scan the workers in order, starting after the thief;
+//1: random victims, trying workers on the same core first, then the same NUMA node, then (SCHEDULER_INT 3 and 5) other NUMA nodes
+//0 by default until it has been measured; --ocr:steal-policy 1 selects the random victims without a rebuild
+#define STEAL_POLICY 0
+
+//A successful steal also moves up to half of the victim's remaining tasks (at most STEAL_BATCH in total) to the thief's queue; 1: steal single tasks
+//1 by default until batches have been measured, as both steal policies steal through the batch
+#define STEAL_BATCH 1
+
+//Idle workers of the task-stealing schedulers. 0: yield, and sleep 10 ms every 10 rounds without a task;
+//1: keep looking for work for an adaptive number of rounds (IDLE_SPIN_MIN to IDLE_SPIN_MAX), then park until a task is pushed that the worker could run
+//0 by default until it has been measured; --ocr:idle-parking 1 selects parking without a rebuild
+#define IDLE_PARKING 0
+#define IDLE_SPIN_MIN 16
+#define IDLE_SPIN_MAX 4096
+
+//Reuse the memory of deleted EDTs and events through per-thread free lists (see memory::object_pool); 0 by default until it has been measured
+#define OBJECT_POOLS 0
+
+//Number of dependence slots, parameters and held DBs that EDTs and events store inline, without allocating (0: always allocate);
+//0 by default until it has been measured, try 4
+#define INLINE_SLOTS 0
+
+//DB acquisition by EDTs (wait_for_graph). 0: each DB has a spin mutex and list waitlists, a release hands the DB over under the waiter's lock;
+//1: the holders of a DB are counted in one atomic word, waitlists are lock-free stacks and one thread at a time hands a DB over to a batch of waiters;
+//0 by default until it has been measured in a multicore build (api_tests test 21)
+#define LOCK_FREE_DB_ACQUIRE 0
+
+//Count the allocations made by the runtime and report them per EDT at shutdown; uses a shared counter, so it slows things down
+#define COUNT_ALLOCATIONS 0
+
 //Use the Bobox scheduler to run tasks.
 //#define SCHEDULER_BOBOX 0 - not supported by this version
 
@@ -58,6 +95,23 @@ Note that some configuration options are exclusive, like ALLOCATOR_STD and ALLOC
 //3: numa_alloc_onnode
 #define ALLOCATOR_INT 0
 
+//Placement of DB data by the NUMA-aware allocators (ALLOCATOR_INT 1 and 3). 0: allocate when the DB is created, on the node of the affinity hint or of the creating worker;
+//1: DBs created with DB_PROP_NO_ACQUIRE and without an affinity hint get their data on the node of the worker that acquires them first;
+//2: as 1, and a DB acquired DB_MIGRATE_AFTER times in a row from another node is migrated to that node
+//0 by default until it has been measured; --ocr:db-placement selects 1 or 2 without a rebuild
+#define DB_PLACEMENT 0
+#define DB_MIGRATE_AFTER 8
+
+//Backing of large DB buffers (at least HUGE_PAGE_MIN_SIZE bytes) with 2 MB pages, Linux only. 0: base pages only;
+//1: transparent huge pages (2 MB aligned mapping with madvise); 2: explicit hugetlb pages, falling back to 1 when none are reserved
+//Not used for the buffers allocated by hbwmalloc (ALLOCATOR_INT 2)
+//Off by default: each such buffer gets a private mapping, so the allocator no longer reuses the memory of freed large DBs
+#define HUGE_PAGES 0
+#define HUGE_PAGE_MIN_SIZE (4 * 1024 * 1024)
+//Sample the THP coverage of freed huge page buffers from /proc/self/smaps for the summary at shutdown (HUGE_PAGES 1 and 2);
+//reading smaps walks the page tables of the process, and the worker that frees the DB waits for it
+#define HUGE_PAGES_SAMPLING 0
+
 //Enable a hack-ish way to use the MCDRAM on KNL. It is based on the fact that the MCDRAM NUMA node is a next sibling of the node with all the cores and it has no cores
 #define KNL_HACK 0
 
@@ -88,7 +142,7 @@ Note that some configuration options are exclusive, like ALLOCATOR_STD and ALLOC
 #endif
 
 #if (ALLOCATOR_INT==1 || ALLOCATOR_INT==3)
-#if (SCHEDULER_INT!=2 && SCHEDULER_INT!=3)
+#if (SCHEDULER_INT<2 || SCHEDULER_INT>5)
 #error The NUMA-aware allocators can only be used with the NUMA-aware scheduler
 #endif
 #if (USE_HWLOC!=1)
@@ -112,6 +166,34 @@ Note that some configuration options are exclusive, like ALLOCATOR_STD and ALLOC
 #error Pinning threads to NUMA nodes and then blocking the threads by their global number is not a good idea.
 #endif
 
+#if (SCHEDULER_INT<0 || SCHEDULER_INT>5)
+#error SCHEDULER_INT must be between 0 and 5
+#endif
+
+#if (STEAL_BATCH<1)
+#error STEAL_BATCH must be at least 1
+#endif
+
+#if (IDLE_SPIN_MIN<1 || IDLE_SPIN_MIN>IDLE_SPIN_MAX)
+#error IDLE_SPIN_MIN must be at least 1 and at most IDLE_SPIN_MAX
+#endif
+
+#if (HUGE_PAGES && defined(_WIN32))
+#error Huge page backing of DBs is only implemented for Linux
+#endif
+
+#if (DB_PLACEMENT<0 || DB_PLACEMENT>2 || DB_MIGRATE_AFTER<1)
+#error DB_PLACEMENT must be between 0 and 2 and DB_MIGRATE_AFTER at least 1
+#endif
+
+#if (HUGE_PAGES<0 || HUGE_PAGES>2)
+#error HUGE_PAGES must be between 0 and 2
+#endif
+
+#if (HUGE_PAGE_MIN_SIZE < 2 * 1024 * 1024)
+#error HUGE_PAGE_MIN_SIZE must be at least the huge page size (2 MB)
+#endif
+
 #if (SCHEDULER_INT==1 && THREAD_BLOCKER>=1)
 #error Due to the ways the headers are currently structured, the single-threaded scheduler cannot be combined with advanced thread blockers. It could be fixed, but the combination does not make sense anyway
 #endif
@@ -124,31 +206,50 @@ Note that some configuration options are exclusive, like ALLOCATOR_STD and ALLOC
 #error Non-tree plan can curently only be enabled if ptrace is enabled, as it uses some of its runtime information
 #endif
 
+#include "ocr_tbb_options.h"
+
+//prints the values in effect, including the ones changed when the program started
 inline void print_config()
 {
+	const ocr_tbb::options& opts = ocr_tbb::options::get();
 #ifdef COMPILER_INFO
 #define COMPILER_XSTR(a) COMPILER_STR(a)
 #define COMPILER_STR(a) #a
 	std::cout << "COMPILER:" << COMPILER_XSTR(COMPILER_INFO) << ';';
 #endif
 	std::cout << "SCHEDULER_TBB:" << SCHEDULER_TBB << ';';
-	std::cout << "SCHEDULER_INT:" << SCHEDULER_INT << ';';
+	std::cout << "SCHEDULER_INT:" << opts.scheduler_int << ';';
+	std::cout << "WORKER_DEQUE_CAPACITY:" << WORKER_DEQUE_CAPACITY << ';';
+	std::cout << "STEAL_POLICY:" << opts.steal_policy << ';';
+	std::cout << "STEAL_BATCH:" << opts.steal_batch << ';';
+	std::cout << "IDLE_PARKING:" << opts.idle_parking << ';';
+	std::cout << "IDLE_SPIN_MIN:" << opts.idle_spin_min << ';';
+	std::cout << "IDLE_SPIN_MAX:" << opts.idle_spin_max << ';';
+	std::cout << "OBJECT_POOLS:" << OBJECT_POOLS << ';';
+	std::cout << "INLINE_SLOTS:" << INLINE_SLOTS << ';';
+	std::cout << "LOCK_FREE_DB_ACQUIRE:" << LOCK_FREE_DB_ACQUIRE << ';';
+	std::cout << "COUNT_ALLOCATIONS:" << COUNT_ALLOCATIONS << ';';
 	std::cout << "USE_HWLOC:" << USE_HWLOC << ';';
-	std::cout << "PIN_THREADS:" << PIN_THREADS << ';';
+	std::cout << "PIN_THREADS:" << opts.pin_threads << ';';
 	std::cout << "THREAD_BLOCKER:" << THREAD_BLOCKER << ";";
 	std::cout << "WITH_ALLOCATORS:" << WITH_ALLOCATORS << ';';
 	std::cout << "ENABLE_DEBUG_COUT:" << ENABLE_DEBUG_COUT << ';';
 	std::cout << "ALLOCATOR_STD:" << ALLOCATOR_STD << ';';
 	std::cout << "ALLOCATOR_TBB:" << ALLOCATOR_TBB << ';';
 	std::cout << "ALLOCATOR_HBW:" << ALLOCATOR_HBW << ';';
-	std::cout << "ALLOCATOR_INT:" << ALLOCATOR_INT << ';';
+	std::cout << "ALLOCATOR_INT:" << opts.allocator_int << ';';
+	std::cout << "DB_PLACEMENT:" << opts.db_placement << ';';
+	std::cout << "DB_MIGRATE_AFTER:" << opts.db_migrate_after << ';';
+	std::cout << "HUGE_PAGES:" << opts.huge_pages << ';';
+	std::cout << "HUGE_PAGE_MIN_SIZE:" << opts.huge_page_min_size << ';';
+	std::cout << "HUGE_PAGES_SAMPLING:" << HUGE_PAGES_SAMPLING << ';';
 	std::cout << "KNL_HACK:" << KNL_HACK << ';';
-	std::cout << "CORE_REDUCTION_FACTOR:" << CORE_REDUCTION_FACTOR << ';';
-	std::cout << "PUBLISH_METRICS:" << PUBLISH_METRICS << ';';
+	std::cout << "CORE_REDUCTION_FACTOR:" << opts.core_reduction_factor << ';';
+	std::cout << "PUBLISH_METRICS:" << opts.publish_metrics << ';';
 	std::cout << "WAIT_FOR_AGENT:" << WAIT_FOR_AGENT << ';';
 	std::cout << "COLLECT_PTRACE:" << COLLECT_PTRACE << ';';
-	std::cout << "USE_PLAN:" << USE_PLAN << ';';
-	std::cout << "IGNORE_APP_HINTS:" << IGNORE_APP_HINTS << ';';
+	std::cout << "USE_PLAN:" << opts.use_plan << ';';
+	std::cout << "IGNORE_APP_HINTS:" << opts.ignore_app_hints << ';';
 	std::cout << std::endl;
 }
 
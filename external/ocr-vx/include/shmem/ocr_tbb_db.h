@@ -9,6 +9,56 @@
 
 namespace ocr_tbb
 {
+#if (LOCK_FREE_DB_ACQUIRE)
+	//EDTs waiting for a DB in one mode, linked through node_data::next_waiting
+	struct db_waitlist
+	{
+		db_waitlist() : last(0)
+		{
+			arrived = 0;
+			first = 0;
+		}
+		bool empty()
+		{
+			return !arrived.load() && !first.load();
+		}
+		tbb::atomic<edt*> arrived;//pushed by the EDTs that could not get the DB, newest first
+		tbb::atomic<edt*> first;//the EDTs taken from arrived, oldest first; only the thread handing the DB over changes them (wait_for_graph::wake_waiters)
+		edt* last;
+	};
+
+	/*
+	The lock of a DB, taken by EDTs before they run (see wait_for_graph).
+	All holders are counted in one word, so that acquiring or releasing the DB is a single compare-and-swap:
+	the RO and RW holders in the low 32 bits, the CONST holders in the next 31 bits and the EW holder in the top bit.
+	EDTs that cannot get the DB push themselves to a waitlist, which is a lock-free stack, as it is never popped from, only taken as a whole.
+	*/
+	struct db_data
+	{
+		static const u64 shared_one = 1;
+		static const u64 shared_mask = 0xFFFFFFFFull;
+		static const u64 const_one = 1ull << 32;
+		static const u64 const_mask = 0x7FFFFFFFull << 32;
+		static const u64 exclusive_write = 1ull << 63;
+		db_data(bool lock)
+		{
+			assert(DB_DEFAULT_MODE == DB_MODE_RW);
+			if (lock) state = shared_one;//the lock of the owner
+			else state = 0;
+			waking = 0;
+		}
+		bool has_waiters()
+		{
+			return !shared_waitlist.empty() || !exclusive_read_waitlist.empty() || !exclusive_write_waitlist.empty();
+		}
+		tbb::atomic<u64> state;
+		db_waitlist shared_waitlist;
+		db_waitlist exclusive_read_waitlist;
+		db_waitlist exclusive_write_waitlist;
+		//requests to hand the DB over to the waiting EDTs; the thread that raises it from 0 serves them all (wait_for_graph::wake_waiters)
+		tbb::atomic<u32> waking;
+	};
+#else
 	struct db_data
 	{
 		db_data(bool lock)
@@ -27,6 +77,7 @@ namespace ocr_tbb
 		typename memory::list<edt*>::the exclusive_write_waitlist;
 		tbb::spin_mutex mutex;
 	};
+#endif
 
 	struct db : public guided
 	{
@@ -34,17 +85,22 @@ namespace ocr_tbb
 		{
 			static const std::size_t alignment = 4096;
 			static const std::size_t padding = 4096;
-			alligned_buffer(std::size_t size, u64 affinity) : len_(size)
+			//a deferred buffer is allocated by the first call of ptr(), on the NUMA node of the calling worker
+			alligned_buffer(std::size_t size, u64 affinity, bool defer) : len_(size)
 			{
-				whole_buffer_ = (char*)memory::manager::allocate_db_buffer(size, alignment, padding, affinity);
+				whole_buffer_ = 0;
+				home_ = 0;
+				if (!defer) allocate(affinity);
 			}
 			~alligned_buffer()
 			{
-				memory::manager::free_db_buffer(whole_buffer_, len_, alignment, padding);
+				if (whole_buffer_) memory::manager::free_db_buffer(whole_buffer_, len_, alignment, padding);
 			}
 			char* ptr()
 			{
-				uintptr_t res = (uintptr_t)whole_buffer_;
+				char* whole = whole_buffer_;
+				if (!whole) whole = allocate_deferred();
+				uintptr_t res = (uintptr_t)whole;
 				res += alignment;
 				res &= ~(alignment - 1);
 				return (char*)res;
@@ -57,10 +113,26 @@ namespace ocr_tbb
 				return res;
 			}
 			std::size_t len_;
-			char* whole_buffer_;
-
+			tbb::atomic<char*> whole_buffer_;
+			tbb::atomic<std::size_t> home_;//the NUMA node of the data, only known to the NUMA-aware allocators
+		private:
+			void allocate(u64 affinity)
+			{
+				char* whole = (char*)memory::manager::allocate_db_buffer(len_, alignment, padding, affinity);
+#if (ALLOCATOR_INT==1 || ALLOCATOR_INT==3)
+				if (options::get().allocator_int) home_ = tasking::scheduler::numa_node_of(affinity);
+#endif
+				whole_buffer_ = whole;//publishes home_ as well
+			}
+			char* allocate_deferred()
+			{
+				tbb::spin_mutex::scoped_lock lock(mutex_);
+				if (!whole_buffer_) allocate(0);
+				return whole_buffer_;
+			}
+			tbb::spin_mutex mutex_;
 		};
-		db(u64 len, ocrInDbAllocator_t allocator, bool lock, u64 affinity) : guided(G_db), len_(len), buffer_(static_cast<std::size_t>(len), affinity), allocator_(allocator), wfg_data_(lock)
+		db(u64 len, ocrInDbAllocator_t allocator, bool lock, u64 affinity) : guided(G_db), len_(len), buffer_(static_cast<std::size_t>(len), affinity, defer_allocation(allocator, lock, affinity)), allocator_(allocator), wfg_data_(lock)
 		{
 #if (WITH_ALLOCATORS)
 			if (allocator == SCALABLE_ALLOC)
@@ -85,8 +157,29 @@ namespace ocr_tbb
 					assert(0);
 				}
 			}
+			else if (allocator == SLAB_ALLOC)
+			{
+				try
+				{
+					slab_pool_ = std::unique_ptr<db_slab_allocator>(new db_slab_allocator(buffer_.ptr(), static_cast<std::size_t>(len)));
+				}
+				catch (...)
+				{
+					assert(0);
+				}
+			}
 #endif
 			reference_count_ = 1;
+			remote_streak_ = 0;
+		}
+		//DB_PLACEMENT 1 and 2 leave the data of DBs created without acquiring them and without a hint to the first EDT that acquires them
+		static bool defer_allocation(ocrInDbAllocator_t allocator, bool lock, u64 affinity)
+		{
+#if (ALLOCATOR_INT==1 || ALLOCATOR_INT==3)
+			return options::get().allocator_int && options::get().db_placement && !lock && !affinity && allocator == NO_ALLOC;
+#else
+			return false;
+#endif
 		}
 		void add_ref()
 		{
@@ -98,10 +191,35 @@ namespace ocr_tbb
 		ocrInDbAllocator_t allocator_;
 		std::unique_ptr<tbb::fixed_pool> pool_;
 		std::unique_ptr<db_allocator> simple_pool_;
+		std::unique_ptr<db_slab_allocator> slab_pool_;
 		char* ptr()
 		{
 			return buffer_.ptr();
 		}
+		//the data for an EDT that acquires the DB, called by the worker running the EDT
+		char* acquire_ptr()
+		{
+			char* res = buffer_.ptr();
+#if (ALLOCATOR_INT==1 || ALLOCATOR_INT==3)
+			const options& opts = options::get();
+			if (!opts.allocator_int) return res;
+			std::size_t node = tasking::scheduler::numa_node_of(0);
+			tasking::scheduler::numa_count_acquire(node, buffer_.home_, buffer_.len_);
+			if (node == buffer_.home_)
+			{
+				remote_streak_ = 0;
+				return res;
+			}
+			//only the acquisition that completes the streak migrates the DB
+			if (opts.db_placement == 2 && ++remote_streak_ == (u32)opts.db_migrate_after)
+			{
+				tasking::scheduler::numa_migrate(res, buffer_.padded_len(), node);
+				buffer_.home_ = node;
+				remote_streak_ = 0;
+			}
+#endif
+			return res;
+		}
 		std::size_t padded_len()
 		{
 			return buffer_.padded_len();
@@ -117,6 +235,7 @@ namespace ocr_tbb
 			{
 			case SCALABLE_ALLOC: return pool_->malloc(size);
 			case SIMPLE_ALLOC: return simple_pool_->malloc(size);
+			case SLAB_ALLOC: return slab_pool_->malloc(size);
 			}
 #endif
 			assert(0);
@@ -129,11 +248,13 @@ namespace ocr_tbb
 			{
 			case SCALABLE_ALLOC: return pool_->free(ptr);
 			case SIMPLE_ALLOC: return simple_pool_->free(ptr);
+			case SLAB_ALLOC: return slab_pool_->free(ptr);
 			}
 #endif
 			assert(0);
 		}
 		tbb::atomic<u32> reference_count_;
+		tbb::atomic<u32> remote_streak_;//consecutive acquisitions from other nodes than the one with the data
 		db_data wfg_data_;
 #if(COLLECT_PTRACE!=0)
 		struct trace_data_type
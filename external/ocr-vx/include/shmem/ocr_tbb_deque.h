@@ -0,0 +1,104 @@
+/*
+ * This file is subject to the license agreement located in the file 
+ * LICENSE_UNIVIE and cannot be distributed without it. This notice
+ * cannot be removed or modified.
+ */
+
+#ifndef OCR_TBB_ocr_tbb_deque_H_GUARD
+#define OCR_TBB_ocr_tbb_deque_H_GUARD
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace ocr_tbb
+{
+	namespace tasking
+	{
+		/*
+		Chase-Lev work-stealing deque, with the memory orderings from Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+		The owning worker pushes and pops at the bottom (LIFO, so it keeps running the tasks it has just made hot in its cache),
+		other workers steal from the top (FIFO, so they take the oldest and usually largest pieces of work).
+		The buffer has a fixed capacity and is never reallocated, so thieves can never read a buffer that is being freed.
+		push fails when the deque is full; the caller then hands the task to a shared queue instead.
+		*/
+		template<typename T, std::size_t Capacity>
+		struct chase_lev_deque
+		{
+			static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity of chase_lev_deque must be a power of two");
+			chase_lev_deque() : top_(0), bottom_(0)
+			{
+				for (std::size_t i = 0; i < Capacity; ++i) buffer_[i].store(T(), std::memory_order_relaxed);
+			}
+			//workers are copied into their vector before any thread runs, so only empty deques are ever copied
+			chase_lev_deque(const chase_lev_deque& other) : chase_lev_deque()
+			{
+				assert(other.size() == 0);
+			}
+			//owner only
+			bool push(T item)
+			{
+				std::int64_t b = bottom_.load(std::memory_order_relaxed);
+				std::int64_t t = top_.load(std::memory_order_acquire);
+				if (b - t >= (std::int64_t)Capacity) return false;
+				buffer_[b & mask].store(item, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				bottom_.store(b + 1, std::memory_order_relaxed);
+				return true;
+			}
+			//owner only
+			bool pop(T& item)
+			{
+				std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+				bottom_.store(b, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::int64_t t = top_.load(std::memory_order_relaxed);
+				if (t > b)
+				{
+					//empty
+					bottom_.store(b + 1, std::memory_order_relaxed);
+					return false;
+				}
+				item = buffer_[b & mask].load(std::memory_order_relaxed);
+				if (t == b)
+				{
+					//last item, race the thieves for it
+					bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+					bottom_.store(b + 1, std::memory_order_relaxed);
+					return won;
+				}
+				return true;
+			}
+			//any thread; also fails when it loses a race with another thief or the owner, the caller just moves on to another victim
+			bool steal(T& item)
+			{
+				std::int64_t t = top_.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::int64_t b = bottom_.load(std::memory_order_acquire);
+				if (t >= b) return false;
+				T x = buffer_[t & mask].load(std::memory_order_relaxed);
+				if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return false;
+				item = x;
+				return true;
+			}
+			//only a snapshot when other threads are active
+			std::size_t size() const
+			{
+				std::int64_t b = bottom_.load(std::memory_order_relaxed);
+				std::int64_t t = top_.load(std::memory_order_relaxed);
+				return (b > t) ? (std::size_t)(b - t) : 0;
+			}
+		private:
+			static const std::int64_t mask = (std::int64_t)Capacity - 1;
+			//top_ is written by thieves and bottom_ by the owner, keep them on separate cache lines
+			std::atomic<std::int64_t> top_;
+			char padding1_[64 - sizeof(std::atomic<std::int64_t>)];
+			std::atomic<std::int64_t> bottom_;
+			char padding2_[64 - sizeof(std::atomic<std::int64_t>)];
+			std::atomic<T> buffer_[Capacity];
+		};
+	}
+}
+
+#endif
@@ -23,7 +23,7 @@ namespace ocr_tbb
 		}
 		static void operator delete (void *p)
 		{
-			memory::manager::free_object<event>(p);
+			memory::manager::free_object<edt_template>(p);
 		}
 	};
 
@@ -63,11 +63,11 @@ namespace ocr_tbb
 		}
 		u32 decrement_ref_count() { return --reference_count_; }
 
-		std::deque<db*> held_dbs_;
-		std::deque<access_mode_t> held_db_modes_;
+		memory::slots<db*>::deque held_dbs_;
+		memory::slots<access_mode_t>::deque held_db_modes_;
 		ocrEdt_t func_;
 		guid_t template_guid;
-		std::vector<u64> params_;
+		memory::slots<u64>::vector params_;
 		bool is_destroyed_;
 		tbb::atomic<u32> reference_count_;
 		guid_t finish_for_children_;
@@ -99,11 +99,11 @@ namespace ocr_tbb
 		ocrHint_t hint;
 		static void* operator new(std::size_t size)
 		{
-			return memory::manager::allocate_object<edt>();
+			return memory::manager::allocate_pooled<edt>();
 		}
 		static void operator delete (void *p)
 		{
-			memory::manager::free_object<edt>(p);
+			memory::manager::free_pooled<edt>(p);
 		}
 	};
 }
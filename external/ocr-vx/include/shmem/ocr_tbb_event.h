@@ -18,11 +18,11 @@ namespace ocr_tbb
 		}
 		static void* operator new(std::size_t size)
 		{
-			return memory::manager::allocate_object<event>();
+			return memory::manager::allocate_pooled<event>();
 		}
 		static void operator delete (void *p)
 		{
-			memory::manager::free_object<event>(p);
+			memory::manager::free_pooled<event>(p);
 		}
 		bool satisfy_preslot(u32 slot, guid_t data)
 		{
@@ -134,8 +134,14 @@ namespace ocr_tbb
 		bool takes_arg_;
 		tbb::atomic<u32> latch_count_;
 		event* finish_parent_;
+#if (INLINE_SLOTS)
+		//lists, unlike deques, do not allocate anything until they are used, and most events are not channels
+		std::list<guid_t> channel_in_queue_;
+		std::list<postslot_t> channel_out_queue_;
+#else
 		std::deque<guid_t> channel_in_queue_;
 		std::deque<postslot_t> channel_out_queue_;
+#endif
 	};
 
 }
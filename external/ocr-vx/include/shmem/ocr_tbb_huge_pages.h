@@ -0,0 +1,167 @@
+/*
+ * This file is subject to the license agreement located in the file 
+ * LICENSE_UNIVIE and cannot be distributed without it. This notice
+ * cannot be removed or modified.
+ */
+
+#ifndef OCR_TBB_ocr_tbb_huge_pages_H_GUARD
+#define OCR_TBB_ocr_tbb_huge_pages_H_GUARD
+
+#if (HUGE_PAGES)
+#include <sys/mman.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << 26)
+#endif
+
+namespace ocr_tbb
+{
+	namespace memory
+	{
+		/*
+		Backing of large DB buffers with 2 MB pages.
+		A buffer of at least options::huge_page_min_size bytes (including alignment and padding) is mapped on its own, rounded up to whole 2 MB pages:
+		- mode 2 first asks for explicit hugetlb pages, which only works if the administrator reserved them (vm.nr_hugepages)
+		- mode 1, and mode 2 when no hugetlb pages are left, maps the buffer at a 2 MB boundary and advises the kernel to use transparent huge pages
+		- if THP is disabled in the kernel, the mapping simply stays on base pages
+		Whether a buffer is mapped here only depends on its size and the options, so the free path recognizes it by the size alone.
+		With HUGE_PAGES_SAMPLING=1, the THP coverage actually achieved is sampled from /proc/self/smaps when buffers are unmapped
+		(at most every 100 ms, as reading smaps walks the page tables); it is off by default, as the sample is taken on the worker that frees the DB.
+		*/
+		struct huge_pages
+		{
+			static const std::size_t page_size = 2 * 1024 * 1024;
+			static bool applies(std::size_t size)
+			{
+				const options& opts = options::get();
+				return opts.huge_pages != 0 && size >= (std::size_t)opts.huge_page_min_size;
+			}
+			static std::size_t mapped_size(std::size_t size)
+			{
+				return (size + page_size - 1) & ~(page_size - 1);
+			}
+			static void* map(std::size_t size)
+			{
+				std::size_t len = mapped_size(size);
+				stats& s = the();
+				if (options::get().huge_pages == 2)
+				{
+					void* res = mmap(0, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+					if (res != MAP_FAILED)
+					{
+						++s.hugetlb_count_;
+						s.hugetlb_size_ += len;
+						return res;
+					}
+					++s.hugetlb_failed_;
+				}
+				//map one more page, so that the buffer can start at a 2 MB boundary, and give back the unused ends
+				char* raw = (char*)mmap(0, len + page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (raw == (char*)MAP_FAILED) throw std::bad_alloc();
+				char* res = (char*)(((uintptr_t)raw + page_size - 1) & ~(uintptr_t)(page_size - 1));
+				if (res != raw) munmap(raw, res - raw);
+				if (raw + page_size != res) munmap(res + len, raw + page_size - res);
+				if (s.thp_enabled_ && madvise(res, len, MADV_HUGEPAGE) == 0)
+				{
+					++s.thp_count_;
+					s.thp_size_ += len;
+				}
+				else
+				{
+					++s.base_count_;
+					s.base_size_ += len;
+				}
+				return res;
+			}
+			static void unmap(void* ptr, std::size_t size)
+			{
+				std::size_t len = mapped_size(size);
+#if (HUGE_PAGES_SAMPLING)
+				the().sample(ptr);
+#endif
+				munmap(ptr, len);
+			}
+			static void print_summary()
+			{
+				stats& s = the();
+				if (!(s.hugetlb_count_ + s.thp_count_ + s.base_count_ + s.hugetlb_failed_)) return;
+				std::cout << "huge pages: " << s.hugetlb_count_ << " DB buffers (" << human_readable(s.hugetlb_size_) << "B) in hugetlb pages, " << s.thp_count_ << " (" << human_readable(s.thp_size_) << "B) advised for THP, " << s.base_count_ << " (" << human_readable(s.base_size_) << "B) on base pages";
+				if (s.hugetlb_failed_) std::cout << ", " << s.hugetlb_failed_ << " hugetlb mappings failed";
+				if (!s.thp_enabled_) std::cout << ", THP disabled in the kernel";
+				std::cout << std::endl;
+				if (s.samples_) std::cout << "THP coverage sampled in " << s.samples_ << " freed buffers: " << human_readable(s.sampled_huge_) << "B of " << human_readable(s.sampled_resident_) << "B resident (" << (s.sampled_resident_ ? 100 * s.sampled_huge_ / s.sampled_resident_ : 0) << "%)" << std::endl;
+			}
+		private:
+			struct stats
+			{
+				stats() : hugetlb_count_(0), hugetlb_size_(0), hugetlb_failed_(0), thp_count_(0), thp_size_(0), base_count_(0), base_size_(0), samples_(0), sampled_huge_(0), sampled_resident_(0), last_sample_(0)
+				{
+					std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+					std::string line;
+					thp_enabled_ = std::getline(enabled, line) && line.find("[never]") == std::string::npos;
+				}
+				//adds the huge and resident sizes of the mapping that contains ptr; hugetlb mappings are not counted, they are huge by construction
+				void sample(void* ptr)
+				{
+					if (!thp_count_) return;
+					u64 now = (u64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+					u64 last = last_sample_.load();
+					if (now < last + 100 || !last_sample_.compare_exchange_strong(last, now)) return;
+					std::ifstream smaps("/proc/self/smaps");
+					std::string line;
+					bool found = false;
+					std::size_t resident = 0, huge = 0, kernel_page = 0;
+					while (std::getline(smaps, line))
+					{
+						uintptr_t from, to;
+						char dash;
+						std::istringstream header(line);
+						if (header >> std::hex >> from >> dash >> to && dash == '-')
+						{
+							if (found) break;
+							found = from <= (uintptr_t)ptr && (uintptr_t)ptr < to;
+							continue;
+						}
+						if (!found) continue;
+						std::istringstream field(line);
+						std::string name;
+						std::size_t kb = 0;
+						field >> name >> kb;
+						if (name == "Rss:") resident = kb << 10;
+						else if (name == "AnonHugePages:") huge = kb << 10;
+						else if (name == "KernelPageSize:") kernel_page = kb << 10;
+					}
+					if (!found || kernel_page >= page_size) return;
+					++samples_;
+					sampled_huge_ += huge;
+					sampled_resident_ += resident;
+				}
+				bool thp_enabled_;
+				std::atomic<std::size_t> hugetlb_count_;
+				std::atomic<std::size_t> hugetlb_size_;
+				std::atomic<std::size_t> hugetlb_failed_;
+				std::atomic<std::size_t> thp_count_;
+				std::atomic<std::size_t> thp_size_;
+				std::atomic<std::size_t> base_count_;
+				std::atomic<std::size_t> base_size_;
+				std::atomic<std::size_t> samples_;
+				std::atomic<std::size_t> sampled_huge_;
+				std::atomic<std::size_t> sampled_resident_;
+				std::atomic<u64> last_sample_;
+			};
+			static stats& the()
+			{
+				static stats the;
+				return the;
+			}
+		};
+	}
+}
+#endif
+
+#endif
@@ -112,6 +112,162 @@ namespace ocr_tbb
 			tbb::spin_mutex::scoped_lock l2;
 		};
 
+#if (LOCK_FREE_DB_ACQUIRE)
+		//the part of db_data::state that counts the holders of a mode
+		static u64 holder_mask(access_mode_t mode)
+		{
+			switch (mode)
+			{
+			case DB_MODE_RW:
+			case DB_MODE_RO:
+				return db_data::shared_mask;
+			case DB_MODE_CONST:
+				return db_data::const_mask;
+			case DB_MODE_EW:
+				return db_data::exclusive_write;
+			}
+			assert(0);
+			return db_data::exclusive_write;//this should never happen
+		}
+
+		static u64 holder_one(access_mode_t mode)
+		{
+			switch (mode)
+			{
+			case DB_MODE_RW:
+			case DB_MODE_RO:
+				return db_data::shared_one;
+			case DB_MODE_CONST:
+				return db_data::const_one;
+			case DB_MODE_EW:
+				return db_data::exclusive_write;
+			}
+			assert(0);
+			return db_data::exclusive_write;//this should never happen
+		}
+
+		//RO and RW share the DB among themselves, so do CONST holders; EW needs it alone
+		static bool lock_available(u64 state, access_mode_t mode)
+		{
+			if (mode == DB_MODE_EW) return state == 0;
+			return (state & ~holder_mask(mode)) == 0;
+		}
+
+		static bool try_lock(db* data, access_mode_t mode)
+		{
+			tbb::atomic<u64>& state = data->wfg_data_.state;
+			for (;;)
+			{
+				u64 current = state;
+				if (!lock_available(current, mode)) return false;
+				if (state.compare_and_swap(current + holder_one(mode), current) == current) return true;
+			}
+		}
+
+		static db_waitlist& waitlist(db* data, access_mode_t mode)
+		{
+			switch (mode)
+			{
+			case DB_MODE_RW:
+			case DB_MODE_RO:
+				return data->wfg_data_.shared_waitlist;
+			case DB_MODE_CONST:
+				return data->wfg_data_.exclusive_read_waitlist;
+			case DB_MODE_EW:
+				return data->wfg_data_.exclusive_write_waitlist;
+			}
+			assert(0);
+			return data->wfg_data_.exclusive_write_waitlist;//this should never happen
+		}
+
+		static void push_waiting(db_waitlist& list, edt* task)
+		{
+			for (;;)
+			{
+				edt* head = list.arrived;
+				task->wfg_node_data_.next_waiting = head;
+				if (list.arrived.compare_and_swap(task, head) == head) return;
+			}
+		}
+
+		//moves the EDTs that arrived in the waitlist behind the ones that have been waiting longer
+		static void collect_waiting(db_waitlist& list)
+		{
+			edt* newest = list.arrived.fetch_and_store(0);
+			if (!newest) return;
+			edt* last = newest;
+			edt* oldest = 0;
+			while (newest)
+			{
+				edt* next = newest->wfg_node_data_.next_waiting;
+				newest->wfg_node_data_.next_waiting = oldest;
+				oldest = newest;
+				newest = next;
+			}
+			if (list.first) list.last->wfg_node_data_.next_waiting = oldest;
+			else list.first = oldest;
+			list.last = last;
+		}
+
+		//gives the DB the task waits for to the task and lets it continue with the remaining DBs; false if the DB is still taken
+		static bool hand_over(db* data, edt* task)
+		{
+			node_data& waiting = task->wfg_node_data_;
+			//the DBs are taken in the order of their guids, so the wait-for graph cannot have a cycle
+			assert(waiting.ordered_guids[waiting.acquired] == data->guid());
+			if (!try_lock(data, waiting.lock_modes[waiting.acquired])) return false;
+			++waiting.acquired;
+			if (try_lock_all(task)) task->spawn();
+			return true;
+		}
+
+		//hands the DB over to the EDTs of the waitlist in the order they came, as long as the holders allow it; returns true if none is left waiting
+		//all EDTs in a waitlist want compatible modes, so when one cannot get the DB, neither can the ones after it
+		static bool hand_over_waiting(db* data, db_waitlist& list)
+		{
+			collect_waiting(list);
+			for (;;)
+			{
+				edt* task = list.first;
+				if (!task) return true;
+				edt* next = task->wfg_node_data_.next_waiting;//read before the hand over, the task may be running afterwards
+				if (!hand_over(data, task)) return false;
+				list.first = next;
+			}
+		}
+
+		//the waiting EW EDTs go first, so the CONST and shared ones cannot starve them
+		static void hand_over_all(db* data)
+		{
+			db_data& lock = data->wfg_data_;
+			if (!hand_over_waiting(data, lock.exclusive_write_waitlist)) return;
+			hand_over_waiting(data, lock.exclusive_read_waitlist);
+			hand_over_waiting(data, lock.shared_waitlist);
+		}
+
+		//called when the DB may have become available to some waiting EDTs;
+		//only one thread hands a DB over at a time, the others just leave it a request and return, so nobody waits for anybody
+		static void wake_waiters(db* data)
+		{
+			tbb::atomic<u32>& waking = data->wfg_data_.waking;
+			if (waking++ != 0) return;
+			for (;;)
+			{
+				u32 requests = waking;
+				hand_over_all(data);
+				if ((waking -= requests) == 0) return;
+			}
+		}
+
+		static void unlock(db* data, access_mode_t mode)
+		{
+			u64 left = (data->wfg_data_.state -= holder_one(mode)) & holder_mask(mode);
+			//a waiting EDT can only be blocked by the mode that was released if it was the last holder of it
+			//the waitlists are read after the state is changed and the waiting EDTs read the state after they are in the waitlist, so one of the two wakes them;
+			//a running hand over gets a request too, it may have seen the DB taken just before
+			if (left == 0 && (data->wfg_data_.waking.load() || data->wfg_data_.has_waiters())) wake_waiters(data);
+		}
+#else
 		static bool try_lock__locked(db* data, access_mode_t mode)
 		{
 			switch (mode)
@@ -230,6 +386,7 @@ namespace ocr_tbb
 				}
 			}
 		}
+#endif
 
 		static void unlock_all(edt* n)
 		{
@@ -268,6 +425,27 @@ namespace ocr_tbb
 			unlock(data, mode);
 		}
 
+#if (LOCK_FREE_DB_ACQUIRE)
+		//takes the DBs of the task, from the first one it does not have yet, in the order of their guids; returns true if the task has them all
+		//otherwise the task waits in the waitlist of the DB that is taken and whoever hands the DB over continues with the rest, so the caller must not touch the task any more
+		static bool try_lock_all(edt* task)
+		{
+			node_data& waiting = task->wfg_node_data_;
+			for (; waiting.acquired < waiting.ordered_guids.size(); ++waiting.acquired)
+			{
+				db* data = guided::from_guid(waiting.ordered_guids[waiting.acquired])->as_db();
+				access_mode_t mode = waiting.lock_modes[waiting.acquired];
+				if (!try_lock(data, mode))
+				{
+					push_waiting(waitlist(data, mode), task);
+					//the holder may have released the DB before the task got in the waitlist, without seeing it there
+					if (lock_available(data->wfg_data_.state, mode)) wake_waiters(data);
+					return false;
+				}
+			}
+			return true;
+		}
+#else
 		static bool try_lock_all__locked(edt* task, db* locked_db)
 		{
 			for (std::size_t i = task->wfg_node_data_.acquired; i < task->wfg_node_data_.ordered_guids.size(); ++i)
@@ -300,6 +478,12 @@ namespace ocr_tbb
 			return true;
 		}
 
+		static bool try_lock_all(edt* task)
+		{
+			return try_lock_all__locked(task, 0);
+		}
+#endif
+
 		u8 satisfy_event_internal__locked(guid_t event_guid, guid_t data_guid, u32 slot)
 		{
 			if (guided::from_guid(event_guid)->type() == G_event)
@@ -369,7 +553,7 @@ namespace ocr_tbb
 							}
 						}
 					}
-					if (try_lock_all__locked(e, 0))
+					if (try_lock_all(e))
 					{
 						e->spawn();
 					}
@@ -50,6 +50,110 @@ namespace ocr_tbb
 			typedef std::list<edt*, allocator<edt*> > the;
 		};
 
+#if (COUNT_ALLOCATIONS)
+		//allocations made by the runtime itself (objects, DB buffers, slots that do not fit inline) and the number of EDTs, reported at shutdown
+		struct allocation_counter
+		{
+			static tbb::atomic<u64>& allocations()
+			{
+				static tbb::atomic<u64> the;
+				return the;
+			}
+			static tbb::atomic<u64>& edts()
+			{
+				static tbb::atomic<u64> the;
+				return the;
+			}
+			static void print_summary()
+			{
+				u64 edt_count = edts();
+				std::cout << "runtime allocations: " << allocations() << " for " << edt_count << " EDTs (" << (edt_count ? (double)allocations() / edt_count : 0) << " per EDT)" << std::endl;
+			}
+		};
+#endif
+
+#if (OBJECT_POOLS)
+		/*
+		Free objects of one type, kept by each thread to save the allocator round-trip for every EDT and event.
+		A thread that has 2 * batch free objects moves a batch of them to a shared depot, a thread that has none takes a batch from there,
+		so that objects created by one thread and deleted by another circulate. The objects are never returned to the allocator.
+		*/
+		template<typename T>
+		struct object_pool
+		{
+			static const std::size_t batch = 64;
+			static void* pop()
+			{
+				cache& c = local();
+				if (!c.free_) c.take_batch();
+				free_object* res = c.free_;
+				if (!res) return 0;
+				c.free_ = res->next_;
+				--c.count_;
+				return res;
+			}
+			static void push(void* obj)
+			{
+				cache& c = local();
+				free_object* o = (free_object*)obj;
+				o->next_ = c.free_;
+				c.free_ = o;
+				if (++c.count_ == 2 * batch) c.give_batch(batch);
+			}
+		private:
+			struct free_object
+			{
+				free_object* next_;
+			};
+			struct depot
+			{
+				tbb::spin_mutex mutex_;
+				std::vector<std::pair<free_object*, std::size_t> > batches_;
+			};
+			struct cache
+			{
+				cache() : free_(0), count_(0) {}
+				~cache()
+				{
+					if (count_) give_batch(count_);//the thread is finishing, let the others use its objects
+				}
+				void take_batch()
+				{
+					depot& d = shared();
+					tbb::spin_mutex::scoped_lock lock(d.mutex_);
+					if (d.batches_.empty()) return;
+					free_ = d.batches_.back().first;
+					count_ = d.batches_.back().second;
+					d.batches_.pop_back();
+				}
+				void give_batch(std::size_t count)
+				{
+					free_object* first = free_;
+					free_object* last = free_;
+					for (std::size_t i = 1; i < count; ++i) last = last->next_;
+					free_ = last->next_;
+					last->next_ = 0;
+					count_ -= count;
+					depot& d = shared();
+					tbb::spin_mutex::scoped_lock lock(d.mutex_);
+					d.batches_.push_back(std::make_pair(first, count));
+				}
+				free_object* free_;
+				std::size_t count_;
+			};
+			static depot& shared()
+			{
+				static depot the;
+				return the;
+			}
+			static cache& local()
+			{
+				static thread_local cache the;
+				return the;
+			}
+		};
+#endif
+
 		struct manager
 		{
 			static void* allocate_db_buffer(std::size_t size, std::size_t allignment, std::size_t padding, u64 affinity);
@@ -70,6 +174,25 @@ namespace ocr_tbb
 			{
 				the().free(obj);
 			}
+			//for the types that are created for every task (EDTs, events); the object must be freed by free_pooled of the same type
+			template<typename T>
+			static T* allocate_pooled()
+			{
+#if (OBJECT_POOLS)
+				void* res = object_pool<T>::pop();
+				if (res) return (T*)res;
+#endif
+				return allocate_object<T>();
+			}
+			template<typename T>
+			static void free_pooled(void* obj)
+			{
+#if (OBJECT_POOLS)
+				object_pool<T>::push(obj);
+#else
+				free_object<T>(obj);
+#endif
+			}
 		private:
 			static manager& the()
 			{
@@ -78,6 +201,9 @@ namespace ocr_tbb
 			static manager the_;
 			void* malloc(std::size_t size, std::size_t allignment, std::size_t padding)
 			{
+#if (COUNT_ALLOCATIONS)
+				++allocation_counter::allocations();
+#endif
 #if (ALLOCATOR_STD)
 				return ::malloc(size + allignment + padding);
 #endif
@@ -11,11 +11,17 @@ namespace ocr_tbb
 {
 	struct node_data
 	{
+#if (LOCK_FREE_DB_ACQUIRE)
+		node_data(u32 depc) : acquired(0), next_waiting(0) {}
+		std::size_t acquired;
+		edt* next_waiting;//the next EDT in the waitlist of the DB this EDT waits for (db_data)
+#else
 		node_data(u32 depc) : acquired(0) {}
 		std::size_t acquired;
+#endif
 		tbb::spin_mutex mutex;
-		std::vector<guid_t> ordered_guids;
-		std::vector<access_mode_t> lock_modes;
+		memory::slots<guid_t>::vector ordered_guids;
+		memory::slots<access_mode_t>::vector lock_modes;
 	};
 
 	struct node : public guided
@@ -59,7 +65,8 @@ namespace ocr_tbb
 
 		node_data wfg_node_data_;
 	protected:
-		std::vector<preslot_t> preslots_;
+		memory::slots<preslot_t>::vector preslots_;
+		//a deque, as notify_task_finished reads it without the lock while add_dependency may append to it; a reallocating vector would free what is being read
 		std::deque<postslot_t> postslots_;
 		node(object_type t, u32 depc) : guided(t), preslots_(depc), wfg_node_data_(depc)
 		{
@@ -0,0 +1,190 @@
+/*
+ * This file is subject to the license agreement located in the file 
+ * LICENSE_UNIVIE and cannot be distributed without it. This notice
+ * cannot be removed or modified.
+ */
+
+#ifndef OCR_TBB_ocr_tbb_options_H_GUARD
+#define OCR_TBB_ocr_tbb_options_H_GUARD
+
+#include <string>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#include "text_exception.h"
+
+namespace ocr_tbb
+{
+	/*
+	Configuration options chosen when the program starts, so that variants can be compared without rebuilding.
+	The macros of ocr_tbb_config.h are the defaults. An option NAME is overridden by the environment variable OCR_NAME,
+	which is in turn overridden by the command line argument --ocr:name <value> (lower case, '-' instead of '_'),
+	for example OCR_SCHEDULER_INT=4 or --ocr:scheduler-int 4.
+	Only variants that are compiled in can be selected:
+	- SCHEDULER_INT can be switched between 2 and 3, or between 4 and 5 (stealing across NUMA nodes on or off); the worker queue type
+	  (concurrent queues for 2 and 3, Chase-Lev deques for 4 and 5) is fixed by the build, as are 0 and 1 (TBB and single-threaded)
+	- ALLOCATOR_INT, PUBLISH_METRICS and USE_PLAN can only be switched off (0) or left at the built value
+	- HUGE_PAGES can be set between 0 and 2 when built with huge page support, 0 otherwise
+	The remaining macros change types or data layout (THREAD_BLOCKER, ALLOCATOR_STD/TBB/HBW, COLLECT_PTRACE, WORKER_DEQUE_CAPACITY,...) and still need a rebuild.
+	The runtime reads the options once at startup; the task-stealing scheduler keeps its own copy of the ones used on the hot path.
+	*/
+	struct options
+	{
+		options()
+			: scheduler_int(SCHEDULER_INT),
+			pin_threads(PIN_THREADS),
+			core_reduction_factor(CORE_REDUCTION_FACTOR),
+			allocator_int(ALLOCATOR_INT),
+			publish_metrics(PUBLISH_METRICS),
+			use_plan(USE_PLAN),
+			ignore_app_hints(IGNORE_APP_HINTS),
+			steal_policy(STEAL_POLICY),
+			steal_batch(STEAL_BATCH),
+			idle_parking(IDLE_PARKING),
+			idle_spin_min(IDLE_SPIN_MIN),
+			idle_spin_max(IDLE_SPIN_MAX),
+			db_placement(DB_PLACEMENT),
+			db_migrate_after(DB_MIGRATE_AFTER),
+			huge_pages(HUGE_PAGES),
+			huge_page_min_size(HUGE_PAGE_MIN_SIZE)
+		{
+		}
+		int scheduler_int;
+		int pin_threads;
+		int core_reduction_factor;
+		int allocator_int;
+		int publish_metrics;
+		int use_plan;
+		int ignore_app_hints;
+		int steal_policy;
+		int steal_batch;
+		int idle_parking;
+		int idle_spin_min;
+		int idle_spin_max;
+		int db_placement;
+		int db_migrate_after;
+		int huge_pages;
+		int huge_page_min_size;
+		static options& get()
+		{
+			static options the;
+			return the;
+		}
+		//reads the environment and removes the recognized --ocr: arguments (with their values) from argv; returns the new argc
+		//must be called before the scheduler is started, throws text_exception for unknown values
+		int parse(int argc, char* argv[])
+		{
+			option_info infos[option_count];
+			describe(infos);
+			for (std::size_t k = 0; k < option_count; ++k)
+			{
+				std::string env_name = "OCR_" + infos[k].name;
+				const char* env = getenv(env_name.c_str());
+				if (env) set(infos[k], env_name, env);
+			}
+			for (int i = 1; i < argc;)
+			{
+				std::string arg(argv[i]);
+				bool found = false;
+				for (std::size_t k = 0; k < option_count && !found; ++k)
+				{
+					if (arg != "--ocr:" + argument_name(infos[k].name)) continue;
+					found = true;
+					if (i + 1 >= argc) throw text_exception(arg + " requires a value");
+					set(infos[k], arg, argv[i + 1]);
+					for (int j = i + 2; j <= argc; ++j)
+					{
+						argv[j - 2] = argv[j];
+					}
+					argc -= 2;
+				}
+				if (!found) ++i;
+			}
+			check();
+			return argc;
+		}
+	private:
+		static const std::size_t option_count = 16;
+		struct option_info
+		{
+			std::string name;
+			int* value;
+			int min;
+			int max;
+			int built;//when not 0, the only allowed values are 0 and this one
+		};
+		void describe(option_info* infos)
+		{
+			int max_value = 1 << 30;
+#if (SCHEDULER_INT==2 || SCHEDULER_INT==3)
+			infos[0] = option_info{ "SCHEDULER_INT", &scheduler_int, 2, 3, 0 };
+#elif (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+			infos[0] = option_info{ "SCHEDULER_INT", &scheduler_int, 4, 5, 0 };
+#else
+			infos[0] = option_info{ "SCHEDULER_INT", &scheduler_int, SCHEDULER_INT, SCHEDULER_INT, 0 };
+#endif
+#if (USE_HWLOC)
+			infos[1] = option_info{ "PIN_THREADS", &pin_threads, 1, 3, 0 };
+#else
+			infos[1] = option_info{ "PIN_THREADS", &pin_threads, 1, 1, 0 };
+#endif
+			infos[2] = option_info{ "CORE_REDUCTION_FACTOR", &core_reduction_factor, 1, max_value, 0 };
+			infos[3] = option_info{ "ALLOCATOR_INT", &allocator_int, 0, ALLOCATOR_INT, ALLOCATOR_INT };
+			infos[4] = option_info{ "PUBLISH_METRICS", &publish_metrics, 0, PUBLISH_METRICS, PUBLISH_METRICS };
+			infos[5] = option_info{ "USE_PLAN", &use_plan, 0, USE_PLAN, USE_PLAN };
+			infos[6] = option_info{ "IGNORE_APP_HINTS", &ignore_app_hints, 0, 3, 0 };
+			infos[7] = option_info{ "STEAL_POLICY", &steal_policy, 0, 1, 0 };
+			infos[8] = option_info{ "STEAL_BATCH", &steal_batch, 1, max_value, 0 };
+			infos[9] = option_info{ "IDLE_PARKING", &idle_parking, 0, 1, 0 };
+			infos[10] = option_info{ "IDLE_SPIN_MIN", &idle_spin_min, 1, max_value, 0 };
+			infos[11] = option_info{ "IDLE_SPIN_MAX", &idle_spin_max, 1, max_value, 0 };
+#if (HUGE_PAGES)
+			infos[12] = option_info{ "HUGE_PAGES", &huge_pages, 0, 2, 0 };
+#else
+			infos[12] = option_info{ "HUGE_PAGES", &huge_pages, 0, 0, 0 };
+#endif
+			infos[13] = option_info{ "HUGE_PAGE_MIN_SIZE", &huge_page_min_size, 2 * 1024 * 1024, max_value, 0 };//at least one 2 MB page
+			infos[14] = option_info{ "DB_PLACEMENT", &db_placement, 0, 2, 0 };
+			infos[15] = option_info{ "DB_MIGRATE_AFTER", &db_migrate_after, 1, max_value, 0 };
+		}
+		static std::string argument_name(const std::string& name)
+		{
+			std::string res(name);
+			for (std::size_t i = 0; i < res.size(); ++i)
+			{
+				if (res[i] == '_') res[i] = '-';
+				else res[i] = (char)tolower(res[i]);
+			}
+			return res;
+		}
+		static void set(const option_info& info, const std::string& source, const char* text)
+		{
+			char* end = 0;
+			errno = 0;
+			long value = strtol(text, &end, 10);
+			if (errno || end == text || *end) throw text_exception(source + ": '" + text + "' is not a number");
+			if (value < info.min || value > info.max || (info.built && value != 0 && value != info.built))
+			{
+				if (info.built) throw text_exception(source + " can only be 0 or " + std::to_string(info.built) + " in this build");
+				throw text_exception(source + " must be between " + std::to_string(info.min) + " and " + std::to_string(info.max) + " in this build");
+			}
+			*info.value = (int)value;
+		}
+		//the checks of ocr_tbb_config.h that depend on options
+		void check()
+		{
+			if (idle_spin_min > idle_spin_max) throw text_exception("IDLE_SPIN_MIN must be at most IDLE_SPIN_MAX");
+#if (THREAD_BLOCKER==2)
+			if (pin_threads != 2) throw text_exception("NUMA thread blocker requires threads to be pinned to NUMA nodes (PIN_THREADS=2).");
+#endif
+#if (THREAD_BLOCKER==1)
+			if (pin_threads == 2) throw text_exception("Pinning threads to NUMA nodes and then blocking the threads by their global number is not a good idea.");
+#endif
+#if (WAIT_FOR_AGENT==1)
+			if (!publish_metrics) throw text_exception("WAIT_FOR_AGENT requires PUBLISH_METRICS, the agent would never be heard.");
+#endif
+		}
+	};
+}
+
+#endif
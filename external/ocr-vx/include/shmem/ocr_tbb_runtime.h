@@ -56,6 +56,7 @@ namespace ocr_tbb
 		}
 		void stop()
 		{
+			if (!options::get().publish_metrics) return;
 			shutdown = true;
 			thread_cond.broadcast();
 			thread.join();
@@ -83,6 +84,7 @@ namespace ocr_tbb
 		}
 		void publish(bool force = false)
 		{
+			if (!options::get().publish_metrics) return;//switched off when the program started
 			tbb::spin_mutex::scoped_lock lock;
 			if (force)
 			{
@@ -129,7 +131,7 @@ namespace ocr_tbb
 		}
 		app_flags_t build_app_flags()
 		{
-			return PIN_THREADS * 10 + THREAD_BLOCKER;
+			return options::get().pin_threads * 10 + THREAD_BLOCKER;
 		}
 	private:
 
@@ -0,0 +1,123 @@
+/*
+ * This file is subject to the license agreement located in the file
+ * LICENSE_UNIVIE and cannot be distributed without it. This notice
+ * cannot be removed or modified.
+ */
+
+#ifndef OCR_TBB_ocr_tbb_small_vector_H_GUARD
+#define OCR_TBB_ocr_tbb_small_vector_H_GUARD
+
+#include <new>
+#include <cstring>
+#include <vector>
+#include <deque>
+
+namespace ocr_tbb
+{
+	namespace memory
+	{
+		/*
+		A vector that keeps up to N elements inside the object, so that EDTs and events with few dependences need no allocation for their slots.
+		Larger contents move to memory::allocator. Only the operations used by the runtime are provided.
+		The elements are moved with memcpy, so T must be trivially copyable (guids, slots, pointers).
+		*/
+		template<typename T, std::size_t N>
+		class small_vector
+		{
+		public:
+			typedef T* iterator;
+			typedef const T* const_iterator;
+			small_vector() : data_(inline_data()), size_(0), capacity_(N)
+			{
+			}
+			explicit small_vector(std::size_t count) : data_(inline_data()), size_(0), capacity_(N)
+			{
+				resize(count);
+			}
+			~small_vector()
+			{
+				clear();
+				if (data_ != inline_data()) allocator<T>().deallocate(data_, capacity_);
+			}
+			std::size_t size() const { return size_; }
+			bool empty() const { return size_ == 0; }
+			T& operator[](std::size_t i) { return data_[i]; }
+			const T& operator[](std::size_t i) const { return data_[i]; }
+			T& front() { return data_[0]; }
+			T& back() { return data_[size_ - 1]; }
+			iterator begin() { return data_; }
+			iterator end() { return data_ + size_; }
+			const_iterator begin() const { return data_; }
+			const_iterator end() const { return data_ + size_; }
+			void reserve(std::size_t count)
+			{
+				if (count <= capacity_) return;
+				T* data = allocator<T>().allocate(count);
+#if (COUNT_ALLOCATIONS)
+				++allocation_counter::allocations();
+#endif
+				if (size_) memcpy((void*)data, (const void*)data_, size_ * sizeof(T));
+				if (data_ != inline_data()) allocator<T>().deallocate(data_, capacity_);
+				data_ = data;
+				capacity_ = count;
+			}
+			void push_back(const T& x)
+			{
+				if (size_ == capacity_) reserve(capacity_ ? 2 * capacity_ : 4);
+				new(data_ + size_) T(x);
+				++size_;
+			}
+			void resize(std::size_t count)
+			{
+				reserve(count);
+				for (std::size_t i = size_; i < count; ++i) new(data_ + i) T();
+				shrink(count);
+			}
+			void resize(std::size_t count, const T& x)
+			{
+				reserve(count);
+				for (std::size_t i = size_; i < count; ++i) new(data_ + i) T(x);
+				shrink(count);
+			}
+			template<typename It>
+			void assign(It first, It last)
+			{
+				clear();
+				reserve((std::size_t)(last - first));
+				for (; first != last; ++first) push_back(*first);
+			}
+			void clear()
+			{
+				shrink(0);
+			}
+		private:
+			small_vector(const small_vector&);
+			small_vector& operator=(const small_vector&);
+			T* inline_data() { return (T*)(void*)inline_; }
+			void shrink(std::size_t count)
+			{
+				for (std::size_t i = count; i < size_; ++i) data_[i].~T();
+				size_ = count;
+			}
+			T* data_;
+			std::size_t size_;
+			std::size_t capacity_;
+			alignas(T) char inline_[(N ? N : 1) * sizeof(T)];
+		};
+
+		//the containers of the slots, parameters and held DBs of EDTs: small_vector with INLINE_SLOTS>0, the standard containers they replaced with 0
+		template<typename T>
+		struct slots
+		{
+#if (INLINE_SLOTS)
+			typedef small_vector<T, INLINE_SLOTS> vector;
+			typedef small_vector<T, INLINE_SLOTS> deque;
+#else
+			typedef std::vector<T> vector;
+			typedef std::deque<T> deque;
+#endif
+		};
+	}
+}
+
+#endif
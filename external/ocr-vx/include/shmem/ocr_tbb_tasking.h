@@ -8,6 +8,7 @@
 #define OCR_TBB_ocr_tbb_tasking_H_GUARD
 
 #include "ocr_tbb_config.h"
+#include "ocr_tbb_deque.h"
 #include "threadqueue.h"
 #include <unordered_map>
 #include <map>
@@ -237,6 +238,18 @@ namespace ocr_tbb
 				{
 					the().numa_free_impl(ptr, size, allignment, padding);
 				}
+				static std::size_t numa_node_of(u64 affinity)
+				{
+					return the().numa_node_of_impl(affinity);
+				}
+				static void numa_count_acquire(std::size_t node, std::size_t home, std::size_t size)
+				{
+					the().numa_count_acquire_impl(node, home, size);
+				}
+				static void numa_migrate(void* ptr, std::size_t size, std::size_t node)
+				{
+					the().numa_migrate_impl(ptr, size, node);
+				}
 #endif
 				static void enter_lab_mode()
 				{
@@ -639,6 +652,11 @@ namespace ocr_tbb
 					epochs_.resize(epoch_durations_.size(), 0);
 					locks_ = new tbb::spin_mutex[epoch_durations_.size()];
 					records_.resize(epoch_durations_.size());
+					spin_ = 0;
+					parked_ = 0;
+					wakeups_ = 0;
+					wake_latency_ = 0;
+					max_wake_latency_ = 0;
 				}
 				~idle_time_tracker()
 				{
@@ -678,6 +696,29 @@ namespace ocr_tbb
 						}
 					}
 				}
+				//how the idle time of IDLE_PARKING=1 is split (all times in microseconds)
+				void report_spin(u64 time)
+				{
+					spin_ += time;
+				}
+				//latency is the time from the wake-up request to the worker running again; timed out parks are not wake-ups
+				void report_parked(u64 time, bool woken, u64 latency)
+				{
+					parked_ += time;
+					if (!woken) return;
+					++wakeups_;
+					wake_latency_ += latency;
+					for (;;)
+					{
+						u64 old = max_wake_latency_.load();
+						if (latency <= old || max_wake_latency_.compare_and_swap(latency, old) == old) break;
+					}
+				}
+				void print_idle_summary()
+				{
+					u64 wakeups = wakeups_.load();
+					std::cout << "idle workers spent " << spin_.load() * 1e-6 << " s spinning and " << parked_.load() * 1e-6 << " s parked; " << wakeups << " wake-ups, latency avg " << (wakeups ? wake_latency_.load() / wakeups : 0) << " us, max " << max_wake_latency_.load() << " us" << std::endl;
+				}
 				double compute_load()
 				{
 					double res = 0;
@@ -765,18 +806,171 @@ namespace ocr_tbb
 					tbb::atomic<u64> count_;
 				};
 				tbb::tick_count start_;
+				tbb::atomic<u64> spin_;
+				tbb::atomic<u64> parked_;
+				tbb::atomic<u64> wakeups_;
+				tbb::atomic<u64> wake_latency_;
+				tbb::atomic<u64> max_wake_latency_;
 				std::vector<tbb::atomic<u64> > epochs_;
 				std::vector<double> epoch_durations_;
 				tbb::spin_mutex* locks_;
 				std::vector<record> records_;
 			};
 
+			/*
+			Idle workers of IDLE_PARKING=1 park here. Each worker waits on its own condition variable, so a wake-up reaches exactly one worker.
+			Every push of a task wakes at most one parked worker, preferably one of the NUMA node the task went to
+			(without stealing across NUMA nodes, workers of other nodes could not run it anyway).
+			A worker registers before parking and then checks for work once more, and a pusher checks for parked workers after pushing;
+			with a full fence on both sides, either the worker sees the task or the pusher sees the worker.
+			The timed wait is only a safety net.
+			A slot's state_ goes from parked to claimed by the pusher that picked it, or back to awake by its worker after a timeout;
+			only the winner of that race may deliver, or withdraw from, the wake-up.
+			*/
+			struct idle_parker
+			{
+				idle_parker() : slots_(0), remote_steal_(false)
+				{
+					parked_count_ = 0;
+					shutdown_ = false;
+				}
+				~idle_parker()
+				{
+					delete[] slots_;
+				}
+				void initialize(std::size_t worker_count, std::size_t node_count, bool remote_steal)
+				{
+					slots_ = new slot[worker_count];
+					sleepers_.resize(node_count);
+					remote_steal_ = remote_steal;
+				}
+				void prepare_park(std::size_t worker, std::size_t node)
+				{
+					slots_[worker].state_.store(parked);
+					tbb::native_mutex::scoped_lock lock(mutex_);
+					sleepers_[node].push_back(worker);
+					parked_count_.fetch_add(1);
+				}
+				//returns true if woken by notify, false after a timeout or at shutdown (then call cancel_park)
+				bool park(std::size_t worker, double& latency)
+				{
+					slot& s = slots_[worker];
+					tbb::native_mutex::scoped_lock lock(s.mutex_);
+					if (!s.wake_ && !shutdown_) s.condvar_.wait(s.mutex_, park_timeout_ms);
+					if (!s.wake_)
+					{
+						int expected = parked;
+						if (s.state_.compare_exchange_strong(expected, awake)) return false;
+						//a pusher claimed this worker just as the wait ended; its wake-up is on the way
+						while (!s.wake_) s.condvar_.wait(s.mutex_);
+					}
+					latency = (tbb::tick_count::now() - s.wake_request_).seconds();
+					s.wake_ = false;
+					s.state_.store(awake);
+					return true;
+				}
+				//the worker did not park after all (it found work, or the wait timed out)
+				void cancel_park(std::size_t worker, std::size_t node)
+				{
+					slot& s = slots_[worker];
+					int expected = parked;
+					if (!s.state_.compare_exchange_strong(expected, awake) && expected == claimed)
+					{
+						//a pusher has already claimed this worker; the worker is awake anyway, just drop the request
+						tbb::native_mutex::scoped_lock slot_lock(s.mutex_);
+						while (!s.wake_) s.condvar_.wait(s.mutex_);
+						s.wake_ = false;
+						s.state_.store(awake);
+						return;
+					}
+					tbb::native_mutex::scoped_lock lock(mutex_);
+					std::vector<std::size_t>& list = sleepers_[node];
+					std::vector<std::size_t>::iterator it = std::find(list.begin(), list.end(), worker);
+					if (it != list.end())
+					{
+						list.erase(it);
+						parked_count_.fetch_sub(1);
+					}
+				}
+				//call after pushing a task that workers of this node can take
+				void notify(std::size_t node)
+				{
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (parked_count_.load(std::memory_order_relaxed) == 0) return;
+					std::size_t worker;
+					{
+						tbb::native_mutex::scoped_lock lock(mutex_);
+						for (;;)
+						{
+							std::size_t from = node;
+							if (remote_steal_)
+							{
+								for (std::size_t i = 0; i < sleepers_.size() && sleepers_[from].empty(); ++i) from = (node + i + 1) % sleepers_.size();
+							}
+							if (sleepers_[from].empty()) return;
+							worker = sleepers_[from].back();
+							sleepers_[from].pop_back();
+							parked_count_.fetch_sub(1);
+							//a worker whose wait has just timed out is leaving; pick another
+							int expected = parked;
+							if (slots_[worker].state_.compare_exchange_strong(expected, claimed)) break;
+						}
+					}
+					slot& s = slots_[worker];
+					tbb::native_mutex::scoped_lock lock(s.mutex_);
+					s.wake_ = true;
+					s.wake_request_ = tbb::tick_count::now();
+					s.condvar_.broadcast();
+				}
+				void shutdown()
+				{
+					shutdown_ = true;
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					for (std::size_t n = 0; n < sleepers_.size(); ++n)
+					{
+						tbb::native_mutex::scoped_lock lock(mutex_);
+						for (std::size_t i = 0; i < sleepers_[n].size(); ++i)
+						{
+							slot& s = slots_[sleepers_[n][i]];
+							tbb::native_mutex::scoped_lock slot_lock(s.mutex_);
+							s.condvar_.broadcast();
+						}
+					}
+				}
+			private:
+				static const int park_timeout_ms = 100;
+				enum { awake, parked, claimed };
+				struct slot
+				{
+					slot() : state_(awake), wake_(false) {}
+					tbb::native_mutex mutex_;
+					tbb::native_condition_varible condvar_;
+					std::atomic<int> state_;
+					bool wake_;
+					tbb::tick_count wake_request_;
+				};
+				slot* slots_;
+				tbb::native_mutex mutex_;
+				std::vector<std::vector<std::size_t> > sleepers_;//parked workers per NUMA node
+				bool remote_steal_;
+				std::atomic<std::size_t> parked_count_;
+				std::atomic<bool> shutdown_;
+			};
+
 			struct taskstealing_runtime
 			{
 				typedef blocker::command command;
 				taskstealing_runtime() : root_(0), shutdown_(false)
 				{
-					std::size_t worker_count = tbb::task_scheduler_init::default_num_threads() / CORE_REDUCTION_FACTOR;
+					const options& opts = options::get();
+					remote_steal_ = (opts.scheduler_int == 3 || opts.scheduler_int == 5);
+					steal_policy_ = opts.steal_policy;
+					steal_batch_ = (std::size_t)opts.steal_batch;
+					idle_parking_ = (opts.idle_parking == 1);
+					idle_spin_min_ = (std::size_t)opts.idle_spin_min;
+					idle_spin_max_ = (std::size_t)opts.idle_spin_max;
+					pin_threads_ = opts.pin_threads;
+					std::size_t worker_count = tbb::task_scheduler_init::default_num_threads() / opts.core_reduction_factor;
 					numa_layout layout;
 #if (USE_HWLOC)
 #ifdef WIN32
@@ -786,11 +980,12 @@ namespace ocr_tbb
 #endif
 					hwloc_topology_init(&topology_);  // initialization
 					hwloc_topology_load(topology_);   // actual detection
-					worker_count = hwloc_get_nbobjs_by_type(topology_, HWLOC_OBJ_PU) / CORE_REDUCTION_FACTOR;
+					worker_count = hwloc_get_nbobjs_by_type(topology_, HWLOC_OBJ_PU) / opts.core_reduction_factor;
 					std::vector<hwloc_const_cpuset_t> cpusets;
 					cpusets.reserve(worker_count);
 					std::vector<std::size_t> nodes;
 					std::vector<std::size_t> local_ids;
+					std::vector<std::size_t> cores;
 					std::size_t node_count = hwloc_get_nbobjs_by_type(topology_, split_by);
 					std::cout << "found " << node_count << " nodes" << std::endl;
 					std::size_t idx = 0;
@@ -798,7 +993,7 @@ namespace ocr_tbb
 					for (std::size_t i = 0; i < node_count; ++i)
 					{
 						hwloc_obj_t node = hwloc_get_obj_by_type(topology_, split_by, (unsigned int)i);
-						std::size_t count = hwloc_get_nbobjs_inside_cpuset_by_type(topology_, node->cpuset, HWLOC_OBJ_PU) / CORE_REDUCTION_FACTOR;
+						std::size_t count = hwloc_get_nbobjs_inside_cpuset_by_type(topology_, node->cpuset, HWLOC_OBJ_PU) / opts.core_reduction_factor;
 						if (count == 0)
 						{
 							std::cout << "\tskipping empty node " << i << std::endl;
@@ -826,37 +1021,52 @@ namespace ocr_tbb
 						nodes_.push_back(numa_node(idx, this, count, node->cpuset, nodeset, mem_nodeset, os_index, mem_os_index));
 						for (std::size_t j = 0; j < count; ++j)
 						{
-#if (PIN_THREADS==2)
-							cpusets.push_back(node->cpuset);
-#endif
-#if (PIN_THREADS==3)
-							hwloc_obj_t core = hwloc_get_obj_inside_cpuset_by_type(topology_, node->cpuset, HWLOC_OBJ_PU, (unsigned int)j);
-							cpusets.push_back(core->cpuset);
-#endif
+							if (pin_threads_ == 2)
+							{
+								cpusets.push_back(node->cpuset);
+							}
+							if (pin_threads_ == 3)
+							{
+								hwloc_obj_t core = hwloc_get_obj_inside_cpuset_by_type(topology_, node->cpuset, HWLOC_OBJ_PU, (unsigned int)j);
+								cpusets.push_back(core->cpuset);
+							}
 							nodes.push_back(idx);
 							local_ids.push_back(j);
+							hwloc_obj_t pu = hwloc_get_obj_inside_cpuset_by_type(topology_, node->cpuset, HWLOC_OBJ_PU, (unsigned int)j);
+							hwloc_obj_t pu_core = hwloc_get_ancestor_obj_by_type(topology_, HWLOC_OBJ_CORE, pu);
+							cores.push_back(pu_core ? pu_core->logical_index : pu->logical_index);
 						}
 						++idx;
 					}
-#if (PIN_THREADS==2 || PIN_THREADS==3)
-					assert(cpusets.size() == worker_count);
-#endif
+					assert(pin_threads_ == 1 || cpusets.size() == worker_count);
 					std::cout << "will use " << nodes_.size() << " nodes for task scheduling" << std::endl;
 #endif
 					workers_.resize(worker_count);
 					blocker_.initialize(worker_count, layout, 0);
+					parker_.initialize(worker_count, std::max<std::size_t>(get_num_affinities_impl(), 1), remote_steal_);
 					for (std::size_t i = 0; i < workers_.size(); ++i)
 					{
 						workers_[i].id_.global_id = (uint32_t)i;
 						workers_[i].parent_ = this;
+						workers_[i].spin_limit_ = idle_spin_min_;
 #if (USE_HWLOC)
-#if (PIN_THREADS==2 || PIN_THREADS==3)
-						workers_[i].cpuset_ = cpusets[i];
-#endif
+						if (pin_threads_ != 1) workers_[i].cpuset_ = cpusets[i];
 						workers_[i].node_ = nodes[i];
+						workers_[i].core_ = cores[i];
 						workers_[i].id_.numa_node = (uint32_t)nodes[i];
 						workers_[i].id_.local_id = (uint32_t)local_ids[i];
 #endif
+						workers_[i].rng_ = (i + 1) * 0x9E3779B97F4A7C15ull;
+					}
+					for (std::size_t i = 0; i < workers_.size(); ++i)
+					{
+						for (std::size_t j = 0; j < workers_.size(); ++j)
+						{
+							if (j != i) workers_[i].victims_[workers_[i].tier_of(workers_[j])].push_back(j);
+						}
+					}
+					for (std::size_t i = 0; i < workers_.size(); ++i)
+					{
 						//the calling thread will be used as thread 0, so do not use it!
 						if (i == 0) threads_.push_back(std::shared_ptr<std::thread>());
 						else threads_.push_back(std::shared_ptr<std::thread>(new std::thread(launcher(&workers_[i]))));//the use of launcher prevents worker from being copied into the thread
@@ -868,12 +1078,21 @@ namespace ocr_tbb
 					for (std::size_t i = 0; i < nodes_.size(); ++i)
 					{
 						std::cout << "node " << i << " executed " << nodes_[i].stat_task_executed_.load() << " tasks (" << nodes_[i].stat_remote_task_stolen_.load() << " stolen from other NUMA nodes) and allocated " << human_readable(nodes_[i].stat_size_allocated_.load()) << "B (" << nodes_[i].stat_size_allocated_.load() << ") in " << nodes_[i].stat_num_allocated_.load() << " blocks" << std::endl;
+#if (ALLOCATOR_INT==1 || ALLOCATOR_INT==3)
+						if (options::get().allocator_int) std::cout << "node " << i << " acquired DBs " << nodes_[i].stat_local_acquired_.load() << " times locally and " << nodes_[i].stat_remote_acquired_.load() << " times from other nodes (" << human_readable(nodes_[i].stat_size_remote_acquired_.load()) << "B), " << nodes_[i].stat_num_migrated_.load() << " DBs (" << human_readable(nodes_[i].stat_size_migrated_.load()) << "B) were migrated here" << std::endl;
+#endif
 					}
 #endif
 					for (std::size_t i = 1/*start with one!*/; i < workers_.size(); ++i)
 					{
 						threads_[i]->join();
 					}
+					for (std::size_t i = 0; i < workers_.size(); ++i)
+					{
+						const worker& w = workers_[i];
+						std::cout << "worker " << i << " stole " << w.stat_stolen_tasks_ << " tasks in " << (w.stat_steals_[0] + w.stat_steals_[1] + w.stat_steals_[2]) << " steals (" << w.stat_steals_[0] << " same core, " << w.stat_steals_[1] << " same node, " << w.stat_steals_[2] << " other nodes), " << w.stat_steal_fails_ << " failed attempts" << std::endl;
+					}
+					if (idle_parking_) tracker_.print_idle_summary();
 #if (USE_HWLOC)
 					hwloc_topology_destroy(topology_);
 #endif
@@ -891,6 +1110,11 @@ namespace ocr_tbb
 						stat_remote_task_stolen_ = 0;
 						stat_num_allocated_ = 0;
 						stat_size_allocated_ = 0;
+						stat_local_acquired_ = 0;
+						stat_remote_acquired_ = 0;
+						stat_size_remote_acquired_ = 0;
+						stat_num_migrated_ = 0;
+						stat_size_migrated_ = 0;
 					}
 					std::size_t id_;
 					taskstealing_runtime* parent_;
@@ -900,6 +1124,12 @@ namespace ocr_tbb
 					tbb::atomic<std::size_t> stat_remote_task_stolen_;
 					tbb::atomic<std::size_t> stat_num_allocated_;
 					tbb::atomic<std::size_t> stat_size_allocated_;
+					//DB acquisitions by EDTs running on this node, by where the data of the DB is
+					tbb::atomic<std::size_t> stat_local_acquired_;
+					tbb::atomic<std::size_t> stat_remote_acquired_;
+					tbb::atomic<std::size_t> stat_size_remote_acquired_;
+					tbb::atomic<std::size_t> stat_num_migrated_;
+					tbb::atomic<std::size_t> stat_size_migrated_;
 					hwloc_const_cpuset_t cpuset_;
 					hwloc_const_nodeset_t nodeset_;
 					hwloc_const_nodeset_t mem_nodeset_;
@@ -909,16 +1139,179 @@ namespace ocr_tbb
 #endif
 				struct worker
 				{
-					worker() : idle_time_(0), busy_time_(0) {}
+					worker() : idle_time_(0), busy_time_(0), spin_limit_(1), rng_(1), stat_stolen_tasks_(0), stat_steal_fails_(0)
+					{
+						stat_steals_[0] = stat_steals_[1] = stat_steals_[2] = 0;
+					}
 					thread_id id_;
 					taskstealing_runtime* parent_;
+#if (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+					chase_lev_deque<task_type*, WORKER_DEQUE_CAPACITY> deque_;
+#else
 					tbb::concurrent_queue<task_type*> queue_;
+#endif
 #if (USE_HWLOC)
 					hwloc_const_cpuset_t cpuset_;
 					std::size_t node_;
+					std::size_t core_;
 #endif
 					u64 idle_time_;
 					u64 busy_time_;
+					std::size_t spin_limit_;//rounds without a task before parking, adapted between IDLE_SPIN_MIN and IDLE_SPIN_MAX
+					//other workers by distance: 0 - same core, 1 - same NUMA node, 2 - other NUMA nodes
+					std::vector<std::size_t> victims_[3];
+					u64 rng_;
+					//stealing statistics, only written by the thread running this worker
+					u64 stat_steals_[3];//successful steals per victim distance
+					u64 stat_stolen_tasks_;//tasks taken by these steals (more than one per steal with STEAL_BATCH>1)
+					u64 stat_steal_fails_;//victims that had nothing to steal or lost the race for it
+					std::size_t tier_of(const worker& other) const
+					{
+#if (USE_HWLOC)
+						if (other.node_ != node_) return 2;
+						if (other.core_ == core_) return 0;
+#endif
+						return 1;
+					}
+					u64 next_random()
+					{
+						//xorshift64*
+						rng_ ^= rng_ >> 12;
+						rng_ ^= rng_ << 25;
+						rng_ ^= rng_ >> 27;
+						return rng_ * 0x2545F4914F6CDD1Dull;
+					}
+					std::size_t queue_size() const
+					{
+#if (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+						return deque_.size();
+#else
+						return (std::size_t)queue_.unsafe_size();
+#endif
+					}
+					//takes one task into t and, with STEAL_BATCH>1, up to half of what the victim has left into the own queue
+					bool steal_from(worker& victim, task_type*& t)
+					{
+						if (!victim.steal(t))
+						{
+							++stat_steal_fails_;
+							return false;
+						}
+						++stat_steals_[tier_of(victim)];
+						++stat_stolen_tasks_;
+						if (parent_->steal_batch_ == 1) return true;
+						std::size_t extra = std::min<std::size_t>(victim.queue_size() / 2, parent_->steal_batch_ - 1);
+						task_type* x;
+						for (; extra > 0 && victim.steal(x); --extra)
+						{
+							push_local(x);
+							++stat_stolen_tasks_;
+						}
+						return true;
+					}
+					//tries every victim of the first tier_count tiers once, closest tiers first, in random order within a tier
+					bool steal_random(task_type*& t, std::size_t tier_count, std::size_t& tier)
+					{
+						for (tier = 0; tier < tier_count; ++tier)
+						{
+							const std::vector<std::size_t>& victims = victims_[tier];
+							std::size_t n = victims.size();
+							if (n == 0) continue;
+							std::size_t start = (std::size_t)(next_random() % n);
+							for (std::size_t i = 0; i < n; ++i)
+							{
+								if (steal_from(parent_->workers_[victims[(start + i) % n]], t)) return true;
+							}
+						}
+						return false;
+					}
+					std::size_t node_index() const
+					{
+#if (USE_HWLOC)
+						return node_;
+#else
+						return 0;
+#endif
+					}
+					//only called by the thread running this worker
+					void push_local(task_type* t)
+					{
+#if (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+						if (!deque_.push(t))
+						{
+							parent_->push_shared(this, t);
+							return;
+						}
+#else
+						queue_.push(t);
+#endif
+						parent_->notify_push(node_index());
+					}
+					//whether any queue this worker takes tasks from looks non-empty; used right before parking
+					bool has_visible_work(std::size_t tier_count)
+					{
+						if (queue_size() > 0) return true;
+#if (USE_HWLOC)
+						if (!parent_->nodes_[node_].queue_.empty()) return true;
+#else
+						if (!parent_->shared_queue_.empty()) return true;
+#endif
+						for (std::size_t tier = 0; tier < tier_count; ++tier)
+						{
+							for (std::size_t i = 0; i < victims_[tier].size(); ++i)
+							{
+								if (parent_->workers_[victims_[tier][i]].queue_size() > 0) return true;
+							}
+						}
+						return false;
+					}
+					//one round without a task: keep looking until the spin limit, then park
+					void idle_round(std::size_t& spin_rounds, tbb::tick_count& spin_start, std::size_t rounds_with_no_task)
+					{
+						if (spin_rounds++ == 0) spin_start = tbb::tick_count::now();
+						if (spin_rounds < spin_limit_)
+						{
+							std::this_thread::yield();
+							return;
+						}
+						std::size_t tier_count = (parent_->remote_steal_ && rounds_with_no_task >= 50) ? 3 : 2;
+						tbb::tick_count park_start = tbb::tick_count::now();
+						parent_->tracker_.report_spin((u64)((park_start - spin_start).seconds() * 1e6));
+						spin_rounds = 0;
+						parent_->parker_.prepare_park(id_.global_id, node_index());
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+						if (has_visible_work(tier_count) || parent_->shutdown_)
+						{
+							parent_->parker_.cancel_park(id_.global_id, node_index());
+							return;
+						}
+						double latency = 0;
+						bool woken = parent_->parker_.park(id_.global_id, latency);
+						if (!woken) parent_->parker_.cancel_park(id_.global_id, node_index());
+						double parked = (tbb::tick_count::now() - park_start).seconds();
+						parent_->tracker_.report_parked((u64)(parked * 1e6), woken, (u64)(latency * 1e6));
+						//work that arrives within a millisecond of parking would have been found by spinning a little longer; long parks mean spinning was wasted
+						if (woken && parked < 0.001) spin_limit_ = std::min<std::size_t>(spin_limit_ * 2, parent_->idle_spin_max_);
+						else if (!woken || parked > 0.01) spin_limit_ = std::max<std::size_t>(spin_limit_ / 2, parent_->idle_spin_min_);
+					}
+					//only called by the thread running this worker
+					bool pop_local(task_type*& t)
+					{
+#if (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+						return deque_.pop(t);
+#else
+						return queue_.try_pop(t);
+#endif
+					}
+					//called by other workers
+					bool steal(task_type*& t)
+					{
+#if (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+						return deque_.steal(t);
+#else
+						return queue_.try_pop(t);
+#endif
+					}
 					void report_idle_time(double time)
 					{
 						idle_time_ += (u64)(time * 1e6);
@@ -931,17 +1324,22 @@ namespace ocr_tbb
 					}
 					void operator()()
 					{
-#if (USE_HWLOC && PIN_THREADS>1)
+#if (USE_HWLOC)
+						if (parent_->pin_threads_ > 1)
+						{
 #ifdef WIN32
-						hwloc_set_thread_cpubind(parent_->topology_, GetCurrentThread(), cpuset_, 0);
+							hwloc_set_thread_cpubind(parent_->topology_, GetCurrentThread(), cpuset_, 0);
 #else
-						hwloc_set_thread_cpubind(parent_->topology_, pthread_self(), cpuset_, 0);
+							hwloc_set_thread_cpubind(parent_->topology_, pthread_self(), cpuset_, 0);
 #endif
+						}
 #endif
 
 						parent_->worker_tls_.local() = this;
 						std::size_t rounds_with_no_task = 0;
 						tbb::tick_count last_task_end = tbb::tick_count::now();
+						std::size_t spin_rounds = 0;
+						tbb::tick_count spin_start;
 						for (;;)
 						{
 							if (parent_->shutdown_) break;
@@ -958,7 +1356,7 @@ namespace ocr_tbb
 							bool is_node = false;
 							bool is_stolen = false;
 							bool is_remote = false;
-							if (queue_.try_pop(t))
+							if (pop_local(t))
 							{
 								is_local = true;
 							}
@@ -967,9 +1365,8 @@ namespace ocr_tbb
 							{
 								is_node = true;
 							}
-#if (SCHEDULER_INT==3)
 							//try stealing from shared queues of other NUMA nodes
-							else if (rounds_with_no_task > 50)
+							else if (parent_->remote_steal_ && rounds_with_no_task > 50)
 							{
 								std::size_t victim = node_;
 								victim = (victim + 1) % parent_->nodes_.size();
@@ -984,40 +1381,68 @@ namespace ocr_tbb
 									is_remote = true;
 								}
 							}
-#endif
+#elif (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+							else if (parent_->shared_queue_.try_pop(t))
+							{
+								is_node = true;
+							}
 #endif
 							if (!t)
 							{
-								std::size_t victim = id_.global_id;
-								for (;;)
+								if (parent_->steal_policy_ == 1)
 								{
-									victim = (victim + 1) % parent_->workers_.size();
-									if (victim == id_.global_id)
+									//other NUMA nodes only after a while without work, like the NUMA-node queues above
+									std::size_t tier_count = (parent_->remote_steal_ && rounds_with_no_task >= 50) ? 3 : 2;
+									std::size_t tier;
+									if (steal_random(t, tier_count, tier))
+									{
+										is_stolen = true;
+										is_remote = (tier == 2);
+									}
+									else
 									{
 										//nothing could be stolen
 										tbb::this_tbb_thread::yield();
-										break;
 									}
+								}
+								else
+								{
+									std::size_t victim = id_.global_id;
+									for (;;)
+									{
+										victim = (victim + 1) % parent_->workers_.size();
+										if (victim == id_.global_id)
+										{
+											//nothing could be stolen
+											tbb::this_tbb_thread::yield();
+											break;
+										}
 #if (USE_HWLOC)
-#if (SCHEDULER_INT==3)
-									if (rounds_with_no_task < 50 && parent_->workers_[victim].node_ != node_) continue;
-#else
-									if (parent_->workers_[victim].node_ != node_) continue;//not very good solution, we should iterate only the relevant workers
-#endif
+										if (parent_->remote_steal_)
+										{
+											if (rounds_with_no_task < 50 && parent_->workers_[victim].node_ != node_) continue;
+										}
+										else if (parent_->workers_[victim].node_ != node_) continue;//not very good solution, we should iterate only the relevant workers
 #endif
-									if (parent_->workers_[victim].queue_.try_pop(t))
-									{
+										if (steal_from(parent_->workers_[victim], t))
+										{
 #if (USE_HWLOC)
-										if (parent_->workers_[victim].node_ != node_) is_remote = true;
+											if (parent_->workers_[victim].node_ != node_) is_remote = true;
 #endif
-										is_stolen = true;
-										break;
+											is_stolen = true;
+											break;
+										}
 									}
 								}
 							}
 							if (t)
 							{
 								rounds_with_no_task = 0;
+								if (spin_rounds > 0)
+								{
+									parent_->tracker_.report_spin((u64)((tbb::tick_count::now() - spin_start).seconds() * 1e6));
+									spin_rounds = 0;
+								}
 #if (USE_HWLOC)
 								++parent_->nodes_[node_].stat_task_executed_;
 								if (is_remote) ++parent_->nodes_[node_].stat_remote_task_stolen_;
@@ -1031,21 +1456,29 @@ namespace ocr_tbb
 								task_type* parent = t->parent();
 								if (parent) parent->increment_ref_count();//tbb::task::destroy decrements the parent's counter
 								task_type::destroy(*t);
-								if (next) queue_.push(next);
+								if (next) push_local(next);
 								if (parent == parent_->root_)
 								{
 									parent_->blocker_.shutdown();
 									parent_->shutdown_ = true;
+									parent_->parker_.shutdown();
 									//parent_->adjust_desired_number_of_threads_impl(parent_->workers_.size());//resume all threads, so that they can shut down
 									break;
 								}
-								if (parent && parent->decrement_ref_count() == 0) queue_.push(parent);
+								if (parent && parent->decrement_ref_count() == 0) push_local(parent);
 							}
 							else
 							{
-								std::this_thread::yield();
 								++rounds_with_no_task;
-								if (rounds_with_no_task % 10 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+								if (parent_->idle_parking_)
+								{
+									idle_round(spin_rounds, spin_start, rounds_with_no_task);
+								}
+								else
+								{
+									std::this_thread::yield();
+									if (rounds_with_no_task % 10 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+								}
 							}
 						}
 					}
@@ -1073,7 +1506,7 @@ namespace ocr_tbb
 					root_ = task_factory<empty_task>::root();
 					root_->set_ref_count(1);
 					root.set_parent(root_);
-					workers_.front().queue_.push(&root);
+					workers_.front().push_local(&root);//the calling thread is about to become worker 0, so this is an owner push
 					run();
 					task_type::destroy(*root_);
 					root_ = 0;
@@ -1088,22 +1521,52 @@ namespace ocr_tbb
 						worker* w = worker_tls_.local(exists);
 						assert(exists);
 						assert(w);
+#if (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+						if (exists && w && w->node_ == index)
+						{
+							w->push_local(&task);
+							return;
+						}
+#else
 						if (!exists || !w) w = &workers_.front();
 						if (w->node_ == index)
 						{
 							w->queue_.push(&task);
+							notify_push(index);
+							return;
 						}
-						else
-						{
-							nodes_[index].queue_.push(&task);
-						}
+#endif
+						nodes_[index].queue_.push(&task);
+						notify_push(index);
 						return;
 					}
 #endif
 					bool exists;
 					worker* w = worker_tls_.local(exists);
+#if (SCHEDULER_INT==4 || SCHEDULER_INT==5)
+					//a deque may only be pushed to by its owner, tasks spawned by other threads go to the shared queue
+					if (!exists || !w) push_shared(0, &task);
+					else w->push_local(&task);
+#else
 					if (!exists || !w) w = &workers_.front();
 					w->queue_.push(&task);
+					notify_push(w->node_index());
+#endif
+				}
+				//wakes a parked worker that can take a task just pushed for this NUMA node
+				void notify_push(std::size_t node)
+				{
+					if (idle_parking_) parker_.notify(node);
+				}
+				//shared tier: the NUMA-node queue of the worker (node 0 for non-worker threads), or one runtime-wide queue without hwloc
+				void push_shared(worker* w, task_type* task)
+				{
+#if(USE_HWLOC)
+					nodes_[w ? w->node_ : 0].queue_.push(task);
+#else
+					shared_queue_.push(task);
+#endif
+					notify_push(w ? w->node_index() : 0);
 				}
 				std::size_t get_num_affinities_impl()
 				{
@@ -1148,11 +1611,16 @@ namespace ocr_tbb
 					if (affinity)
 					{
 						std::size_t index = (-(s64)affinity) - 1;
+						void* res;
+#if (HUGE_PAGES)
+						if (memory::huge_pages::applies(size + allignment + padding)) res = numa_map_huge(size + allignment + padding, index);
+						else
+#endif
 #if(ALLOCATOR_INT==1)
-						void* res = hwloc_alloc_membind_nodeset(topology_, size + allignment + padding, nodes_[index].nodeset_, HWLOC_MEMBIND_BIND, 0);
+						res = hwloc_alloc_membind_nodeset(topology_, size + allignment + padding, nodes_[index].nodeset_, HWLOC_MEMBIND_BIND, 0);
 #endif
 #if(ALLOCATOR_INT==3)
-						void* res = numa_alloc_onnode(size + allignment + padding, nodes_[index].mem_os_index_);
+						res = numa_alloc_onnode(size + allignment + padding, nodes_[index].mem_os_index_);
 #endif
 						++nodes_[index].stat_num_allocated_;
 						nodes_[index].stat_size_allocated_ += size + allignment + padding;
@@ -1163,22 +1631,75 @@ namespace ocr_tbb
 					{
 						bool exists;
 						worker* w = worker_tls_.local(exists);
-						assert(exists);
-						assert(w);
+						//a deferred DB buffer may be materialized outside of the workers (e.g. by a task backup); leave its placement to the first touch
+						if (!exists || !w) return numa_malloc_unplaced(size + allignment + padding);
 						++nodes_[w->node_].stat_num_allocated_;
 						nodes_[w->node_].stat_size_allocated_ += size + allignment + padding;
+						void* res;
+#if (HUGE_PAGES)
+						if (memory::huge_pages::applies(size + allignment + padding)) res = numa_map_huge(size + allignment + padding, w->node_);
+						else
+#endif
 #if(ALLOCATOR_INT==1)
-						void* res = hwloc_alloc_membind_nodeset(topology_, size + allignment + padding, nodes_[w->node_].nodeset_, HWLOC_MEMBIND_BIND, 0);
+						res = hwloc_alloc_membind_nodeset(topology_, size + allignment + padding, nodes_[w->node_].nodeset_, HWLOC_MEMBIND_BIND, 0);
 #endif
 #if(ALLOCATOR_INT==3)
-						void* res = numa_alloc_onnode(size + allignment + padding, nodes_[w->node_].mem_os_index_);
+						res = numa_alloc_onnode(size + allignment + padding, nodes_[w->node_].mem_os_index_);
 #endif
 						if (!res) throw std::bad_alloc();
 						return res;
 					}
 				}
+				void* numa_malloc_unplaced(std::size_t size)
+				{
+					void* res;
+#if (HUGE_PAGES)
+					if (memory::huge_pages::applies(size)) return memory::huge_pages::map(size);
+#endif
+#if(ALLOCATOR_INT==1)
+					res = hwloc_alloc(topology_, size);
+#endif
+#if(ALLOCATOR_INT==3)
+					res = numa_alloc(size);
+#endif
+					if (!res) throw std::bad_alloc();
+					return res;
+				}
+				//the node of an affinity, 0 stands for the node of the calling worker; other threads get the first node, as their allocations are not placed
+				std::size_t numa_node_of_impl(u64 affinity)
+				{
+					if (affinity) return (-(s64)affinity) - 1;
+					bool exists;
+					worker* w = worker_tls_.local(exists);
+					if (!exists || !w) return 0;
+					return w->node_;
+				}
+				void numa_count_acquire_impl(std::size_t node, std::size_t home, std::size_t size)
+				{
+					if (node == home)
+					{
+						++nodes_[node].stat_local_acquired_;
+						return;
+					}
+					++nodes_[node].stat_remote_acquired_;
+					nodes_[node].stat_size_remote_acquired_ += size;
+				}
+				//the pages keep their addresses, so EDTs may keep using the data while it moves
+				void numa_migrate_impl(void* ptr, std::size_t size, std::size_t node)
+				{
+					if (hwloc_set_area_membind_nodeset(topology_, ptr, size, nodes_[node].nodeset_, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_MIGRATE) != 0) return;
+					++nodes_[node].stat_num_migrated_;
+					nodes_[node].stat_size_migrated_ += size;
+				}
 				void numa_free_impl(void* ptr, std::size_t size, std::size_t allignment, std::size_t padding)
 				{
+#if (HUGE_PAGES)
+					if (memory::huge_pages::applies(size + allignment + padding))
+					{
+						memory::huge_pages::unmap(ptr, size + allignment + padding);
+						return;
+					}
+#endif
 #if(ALLOCATOR_INT==1)
 					hwloc_free(topology_, ptr, size + allignment + padding);
 #endif
@@ -1186,6 +1707,20 @@ namespace ocr_tbb
 					//::numa_free(ptr, size + allignment + padding);
 #endif
 				}
+#endif
+#if (HUGE_PAGES && (ALLOCATOR_INT==1 || ALLOCATOR_INT==3))
+				//the pages are bound to the node before they are touched; hugetlb pages come from the node's own pool
+				void* numa_map_huge(std::size_t size, std::size_t node)
+				{
+					void* res = memory::huge_pages::map(size);
+#if(ALLOCATOR_INT==1)
+					hwloc_set_area_membind_nodeset(topology_, res, memory::huge_pages::mapped_size(size), nodes_[node].nodeset_, HWLOC_MEMBIND_BIND, 0);
+#endif
+#if(ALLOCATOR_INT==3)
+					numa_tonode_memory(res, memory::huge_pages::mapped_size(size), nodes_[node].mem_os_index_);
+#endif
+					return res;
+				}
 #endif
 				void run()
 				{
@@ -1197,12 +1732,24 @@ namespace ocr_tbb
 				std::vector<numa_node> nodes_;
 #endif
 				std::vector<worker> workers_;
+#if (!USE_HWLOC)
+				tbb::concurrent_queue<task_type*> shared_queue_;//the shared tier of the deques
+#endif
 				std::vector<std::shared_ptr<std::thread> > threads_;
 				tbb::enumerable_thread_specific<worker*> worker_tls_;
 				task_type* root_;
 				tbb::atomic<bool> shutdown_;
 				blocker blocker_;
 				idle_time_tracker tracker_;
+				idle_parker parker_;
+				//scheduler variant and tuning, copied from the options when the runtime starts
+				bool remote_steal_;//stealing across NUMA nodes (SCHEDULER_INT 3 and 5)
+				int steal_policy_;
+				std::size_t steal_batch_;
+				bool idle_parking_;
+				std::size_t idle_spin_min_;
+				std::size_t idle_spin_max_;
+				int pin_threads_;
 			};
 		}
 
@@ -1217,7 +1764,7 @@ namespace ocr_tbb
 #if (SCHEDULER_INT==1)
 		typedef internal_scheduler::singlethreaded_runtime runtime;
 #endif
-#if (SCHEDULER_INT==2 || SCHEDULER_INT==3)
+#if (SCHEDULER_INT>=2 && SCHEDULER_INT<=5)
 		typedef internal_scheduler::taskstealing_runtime runtime;
 #endif
 		typedef internal_scheduler::task_type task_type;
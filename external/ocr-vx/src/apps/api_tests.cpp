@@ -13,6 +13,7 @@
 #include <extensions/ocr-heterogeneous.h>
 #endif
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include "parallelization.h"//for tbb thread
 #include <vector>
@@ -38,6 +39,11 @@
 #else
 #define TEST_CHANNEL 0
 #endif
+#ifdef ENABLE_EXTENSION_DB_ALLOCATORS
+#define TEST_DB_ALLOCATORS 1
+#else
+#define TEST_DB_ALLOCATORS 0
+#endif
 
 #if (TEST_MAP)
 #include "ocr-map-creator.h"
@@ -1662,9 +1668,310 @@ ocrGuid_t test17_start(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
 }
 #endif
 
+//binary tree of empty EDTs, each spawned by its parent; measures how fast the scheduler spawns and distributes tasks
+struct test18_args
+{
+	guid_t node_template;
+	u64 depth;
+};
+
+struct test18_done_args
+{
+	guid_t node_template;
+	u64 depth;
+	u64 start_ns;
+};
+
+u64 test18_now_ns()
+{
+	return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ocrGuid_t test18_node(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test18_args args = *(test18_args*)paramv;
+	if (args.depth == 0) return NULL_GUID;
+	--args.depth;
+	for (int i = 0; i < 2; ++i)
+	{
+		guid_t child;
+		ocrEdtCreate(&child, args.node_template, EDT_PARAM_DEF, (u64*)&args, EDT_PARAM_DEF, 0, EDT_PROP_NONE, NULL_HINT, 0);
+	}
+	return NULL_GUID;
+}
+
+ocrGuid_t test18_done(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test18_done_args* args = (test18_done_args*)paramv;
+	double seconds = (test18_now_ns() - args->start_ns) * 1e-9;
+	u64 task_count = (((u64)2) << args->depth) - 1;
+	std::cout << "spawn tree of depth " << args->depth << ": " << task_count << " EDTs in " << seconds << " s (" << (u64)(task_count / seconds) << " EDTs/s)" << std::endl;
+	ocrEdtTemplateDestroy(args->node_template);
+	ocrShutdown();
+	return NULL_GUID;
+}
+
+ocrGuid_t test18_start(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	u64 depth = (paramc > 0 && paramv[0] > 0) ? paramv[0] : 20;
+	guid_t node_template, done_template, root, root_event, done;
+	ocrEdtTemplateCreate(&node_template, test18_node, sizeof(test18_args) / sizeof(u64), 0);
+	ocrEdtTemplateCreate(&done_template, test18_done, sizeof(test18_done_args) / sizeof(u64), 1);
+	test18_done_args done_args = { node_template, depth, test18_now_ns() };
+	ocrEdtCreate(&done, done_template, EDT_PARAM_DEF, (u64*)&done_args, EDT_PARAM_DEF, 0, EDT_PROP_NONE, NULL_HINT, 0);
+	ocrEdtTemplateDestroy(done_template);
+	test18_args root_args = { node_template, depth };
+	ocrEdtCreate(&root, node_template, EDT_PARAM_DEF, (u64*)&root_args, EDT_PARAM_DEF, 0, EDT_PROP_FINISH, NULL_HINT, &root_event);
+	ocrAddDependence(root_event, done, 0, DB_DEFAULT_MODE);
+	return NULL_GUID;
+}
+
+#if (TEST_DB_ALLOCATORS)
+//many EDTs allocating small blocks in one DB heap, then freeing the blocks of another EDT; compares the in-DB allocators (needs WITH_ALLOCATORS)
+struct test19_args
+{
+	guid_t heap;
+	guid_t work_template;
+	u64 index;
+};
+
+struct test19_phase_args
+{
+	test19_args work;
+	u64 time_index;//which time stamp the phase takes when it starts
+};
+
+struct test19_done_args
+{
+	u64 allocator;
+	guid_t alloc_template;
+	guid_t free_template;
+};
+
+static const u64 test19_workers = 64;
+//the same for all allocators, so that their rates compare; first fit (SIMPLE_ALLOC) walks the live blocks on every malloc,
+//which keeps the count at a few hundred per worker (16000 blocks, a 16 MB heap)
+static const u64 test19_blocks_per_worker = 250;
+static std::vector<void*> test19_blocks;
+static u64 test19_times[3];
+
+ocrGuid_t test19_alloc(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test19_args* args = (test19_args*)paramv;
+	void** blocks = &test19_blocks[args->index * test19_blocks_per_worker];
+	u64 seed = args->index * 2654435761u + 1;
+	for (u64 i = 0; i < test19_blocks_per_worker; ++i)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		u64 size = 16 + (seed >> 33) % 497;
+		if (ocrDbMalloc(args->heap, size, &blocks[i]) != 0) blocks[i] = 0;
+		else memset(blocks[i], (int)args->index, 16);
+	}
+	return NULL_GUID;
+}
+
+ocrGuid_t test19_free(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test19_args* args = (test19_args*)paramv;
+	//free the blocks of the next worker, which were most likely allocated by another thread
+	void** blocks = &test19_blocks[((args->index + 1) % test19_workers) * test19_blocks_per_worker];
+	for (u64 i = 0; i < test19_blocks_per_worker; ++i)
+	{
+		if (blocks[i]) ocrDbFree(args->heap, blocks[i]);
+	}
+	return NULL_GUID;
+}
+
+//FINISH EDT that runs one phase: a work EDT per worker
+ocrGuid_t test19_phase(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test19_phase_args* phase = (test19_phase_args*)paramv;
+	test19_times[phase->time_index] = test18_now_ns();
+	test19_args args = phase->work;
+	for (args.index = 0; args.index < test19_workers; ++args.index)
+	{
+		guid_t edt;
+		ocrEdtCreate(&edt, args.work_template, EDT_PARAM_DEF, (u64*)&args, EDT_PARAM_DEF, 0, EDT_PROP_NONE, NULL_HINT, 0);
+	}
+	return NULL_GUID;
+}
+
+ocrGuid_t test19_done(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test19_done_args* args = (test19_done_args*)paramv;
+	test19_times[2] = test18_now_ns();
+	u64 failed = 0;
+	for (std::size_t i = 0; i < test19_blocks.size(); ++i) if (!test19_blocks[i]) ++failed;
+	double count = (double)(test19_workers * test19_blocks_per_worker);
+	double alloc_seconds = (test19_times[1] - test19_times[0]) * 1e-9;
+	double free_seconds = (test19_times[2] - test19_times[1]) * 1e-9;
+	std::cout << "DB allocator " << args->allocator << ": " << (u64)count << " blocks by " << test19_workers << " EDTs, malloc " << (u64)(count / alloc_seconds) << "/s, remote free " << (u64)(count / free_seconds) << "/s, " << failed << " failed" << std::endl;
+	ocrEdtTemplateDestroy(args->alloc_template);
+	ocrEdtTemplateDestroy(args->free_template);
+	ocrDbDestroy(depv[0].guid);
+	ocrShutdown();
+	return NULL_GUID;
+}
+
+ocrGuid_t test19_start(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	u64 allocator = (paramc > 0 && paramv[0] > 0) ? paramv[0] : SLAB_ALLOC;
+	test19_blocks.assign(test19_workers * test19_blocks_per_worker, 0);
+	guid_t heap;
+	void* heap_ptr;
+	ocrDbCreate(&heap, &heap_ptr, test19_workers * test19_blocks_per_worker * 1024, DB_PROP_NO_ACQUIRE, NULL_HINT, (ocrInDbAllocator_t)allocator);
+	guid_t phase_template, alloc_template, free_template, done_template;
+	ocrEdtTemplateCreate(&phase_template, test19_phase, 4, 1);
+	ocrEdtTemplateCreate(&alloc_template, test19_alloc, 3, 0);
+	ocrEdtTemplateCreate(&free_template, test19_free, 3, 0);
+	ocrEdtTemplateCreate(&done_template, test19_done, 3, 2);
+	test19_phase_args alloc_args = { { heap, alloc_template, 0 }, 0 };
+	test19_phase_args free_args = { { heap, free_template, 0 }, 1 };
+	test19_done_args done_args = { allocator, alloc_template, free_template };
+	guid_t alloc_phase, free_phase, done, alloc_event, free_event;
+	ocrEdtCreate(&done, done_template, EDT_PARAM_DEF, (u64*)&done_args, EDT_PARAM_DEF, 0, EDT_PROP_NONE, NULL_HINT, 0);
+	ocrEdtCreate(&free_phase, phase_template, EDT_PARAM_DEF, (u64*)&free_args, EDT_PARAM_DEF, 0, EDT_PROP_FINISH, NULL_HINT, &free_event);
+	ocrEdtCreate(&alloc_phase, phase_template, EDT_PARAM_DEF, (u64*)&alloc_args, EDT_PARAM_DEF, 0, EDT_PROP_FINISH, NULL_HINT, &alloc_event);
+	ocrAddDependence(heap, done, 0, DB_MODE_RW);
+	ocrAddDependence(free_event, done, 1, DB_DEFAULT_MODE);
+	ocrAddDependence(alloc_event, free_phase, 0, DB_DEFAULT_MODE);
+	ocrEdtTemplateDestroy(phase_template);
+	ocrEdtTemplateDestroy(done_template);
+	return NULL_GUID;
+}
+#endif
+
+//random reads in one large DB, to compare the page backing of DBs (built with HUGE_PAGES, run with --ocr:huge-pages 0, 1 or 2); run under perf stat -e dTLB-load-misses for the TLB misses
+static const u64 test20_reads = 64 * 1024 * 1024;
+
+ocrGuid_t test20_work(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	u64* data = (u64*)depv[0].ptr;
+	u64 count = paramv[0] * 1024 * 1024 / sizeof(u64);
+	u64 start = test18_now_ns();
+	for (u64 i = 0; i < count; ++i) data[i] = i;
+	u64 touched = test18_now_ns();
+	u64 index = 0, sum = 0;
+	for (u64 i = 0; i < test20_reads; ++i)
+	{
+		index = (index * 6364136223846793005ull + 1442695040888963407ull);
+		sum += data[(index >> 17) % count];
+	}
+	u64 done = test18_now_ns();
+	std::cout << "DB of " << paramv[0] << " MB: first touch " << (touched - start) * 1e-9 << " s, " << (double)(done - touched) / test20_reads << " ns per random read (checksum " << sum << ")" << std::endl;
+	ocrDbDestroy(depv[0].guid);
+	ocrShutdown();
+	return NULL_GUID;
+}
+
+ocrGuid_t test20_start(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	u64 megabytes = (paramc > 0 && paramv[0] > 0) ? paramv[0] : 1024;
+	guid_t data, work_template, work;
+	void* data_ptr;
+	ocrDbCreate(&data, &data_ptr, megabytes * 1024 * 1024, DB_PROP_NO_ACQUIRE, NULL_HINT, NO_ALLOC);
+	ocrEdtTemplateCreate(&work_template, test20_work, 1, 1);
+	ocrEdtCreate(&work, work_template, EDT_PARAM_DEF, &megabytes, EDT_PARAM_DEF, &data, EDT_PROP_NONE, NULL_HINT, 0);
+	ocrEdtTemplateDestroy(work_template);
+	return NULL_GUID;
+}
+
+//many EDTs made runnable at once, all acquiring the same DB, in each mode and then in all modes mixed; reports the acquisitions per second
+//the EW EDTs increment a counter in the DB without synchronization, so a lost increment means two EW EDTs held the DB at the same time
+//build with LOCK_FREE_DB_ACQUIRE 0 and 1 to compare the two ways of acquiring DBs
+struct test21_args
+{
+	guid_t data;
+	guid_t work_template;
+	guid_t phase_template;
+	guid_t done_template;
+	u64 count;
+	u64 mode;
+};
+
+static const ocrDbAccessMode_t test21_modes[] = { DB_MODE_RO, DB_MODE_RW, DB_MODE_CONST, DB_MODE_EW };
+static const u64 test21_mode_count = 4;
+static const char* const test21_mode_names[] = { "RO", "RW", "CONST", "EW", "mixed" };
+static u64 test21_start_ns = 0;
+
+ocrGuid_t test21_work(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	if (paramv[0]) ++*(u64*)depv[0].ptr;
+	return NULL_GUID;
+}
+
+ocrGuid_t test21_phase(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test21_args* args = (test21_args*)paramv;
+	guid_t ready;
+	ocrEventCreate(&ready, OCR_EVENT_ONCE_T, EVT_PROP_TAKES_ARG);
+	for (u64 i = 0; i < args->count; ++i)
+	{
+		ocrDbAccessMode_t mode = test21_modes[(args->mode < test21_mode_count) ? args->mode : i % test21_mode_count];
+		u64 increment = (mode == DB_MODE_EW) ? 1 : 0;
+		guid_t work;
+		ocrEdtCreate(&work, args->work_template, EDT_PARAM_DEF, &increment, EDT_PARAM_DEF, 0, EDT_PROP_NONE, NULL_HINT, 0);
+		ocrAddDependence(ready, work, 0, mode);
+	}
+	test21_start_ns = test18_now_ns();
+	ocrEventSatisfy(ready, args->data);
+	return NULL_GUID;
+}
+
+void test21_run_phase(test21_args& args)
+{
+	guid_t phase, phase_event, done;
+	ocrEdtCreate(&done, args.done_template, EDT_PARAM_DEF, (u64*)&args, EDT_PARAM_DEF, 0, EDT_PROP_NONE, NULL_HINT, 0);
+	ocrEdtCreate(&phase, args.phase_template, EDT_PARAM_DEF, (u64*)&args, EDT_PARAM_DEF, 0, EDT_PROP_FINISH, NULL_HINT, &phase_event);
+	ocrAddDependence(args.data, done, 0, DB_MODE_RW);
+	ocrAddDependence(phase_event, done, 1, DB_DEFAULT_MODE);
+}
+
+ocrGuid_t test21_done(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test21_args args = *(test21_args*)paramv;
+	u64* counter = (u64*)depv[0].ptr;
+	double seconds = (test18_now_ns() - test21_start_ns) * 1e-9;
+	u64 exclusive = (args.mode < test21_mode_count) ? ((test21_modes[args.mode] == DB_MODE_EW) ? args.count : 0) : args.count / test21_mode_count;
+	std::cout << "hot DB, " << test21_mode_names[args.mode] << ": " << args.count << " acquisitions in " << seconds << " s (" << (u64)(args.count / seconds) << " acquisitions/s)";
+	if (*counter != exclusive) std::cout << ", EW acquisitions overlapped (" << *counter << " of " << exclusive << " increments)";
+	std::cout << std::endl;
+	*counter = 0;
+	if (args.mode < test21_mode_count)
+	{
+		ocrDbRelease(depv[0].guid);
+		++args.mode;
+		test21_run_phase(args);
+		return NULL_GUID;
+	}
+	ocrEdtTemplateDestroy(args.work_template);
+	ocrEdtTemplateDestroy(args.phase_template);
+	ocrEdtTemplateDestroy(args.done_template);
+	ocrDbDestroy(depv[0].guid);
+	ocrShutdown();
+	return NULL_GUID;
+}
+
+ocrGuid_t test21_start(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
+{
+	test21_args args;
+	args.count = (paramc > 0 && paramv[0] > 0) ? paramv[0] : 100000;
+	args.mode = 0;
+	u64* counter;
+	ocrDbCreate(&args.data, (void**)&counter, sizeof(u64), DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+	*counter = 0;
+	ocrDbRelease(args.data);
+	ocrEdtTemplateCreate(&args.work_template, test21_work, 1, 1);
+	ocrEdtTemplateCreate(&args.phase_template, test21_phase, sizeof(test21_args) / sizeof(u64), 0);
+	ocrEdtTemplateCreate(&args.done_template, test21_done, sizeof(test21_args) / sizeof(u64), 2);
+	test21_run_phase(args);
+	return NULL_GUID;
+}
+
 extern "C" ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[])
 {
-	if (getArgc(depv[0].ptr) != 2)
+	u64 argc = getArgc(depv[0].ptr);
+	if (argc != 2 && argc != 3)
 	{
 		std::cout << "Specify the test to run:" << std::endl;
 		std::cout << "1 - test affinity and exclusive data access" << std::endl;
@@ -1706,10 +2013,17 @@ extern "C" ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv
 #if (TEST_BYVALUEDB)
 		std::cout << "17 - test by-value DBs" << std::endl;
 #endif
+		std::cout << "18 [depth] - recursive spawn tree, reports EDTs/s (default depth 20)" << std::endl;
+#if (TEST_DB_ALLOCATORS)
+		std::cout << "19 [allocator] - concurrent ocrDbMalloc and remote ocrDbFree in one DB; 1 - scalable, 2 - simple, 3 - slab (default)" << std::endl;
+#endif
+		std::cout << "20 [MB] - random reads in one large DB, reports ns per read (default 1024 MB)" << std::endl;
+		std::cout << "21 [EDTs] - EDTs acquiring one hot DB in each mode, reports acquisitions/s (default 100000 EDTs per mode)" << std::endl;
 		ocrShutdown();
 		return NULL_GUID;
 	}
 	int test = atoi(getArgv(depv[0].ptr, 1));
+	u64 test_arg = (argc == 3) ? (u64)atoll(getArgv(depv[0].ptr, 2)) : 0;
 	ocrDbDestroy(depv[0].guid);
 	switch (test)
 	{
@@ -1752,6 +2066,12 @@ extern "C" ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv
 #if (TEST_BYVALUEDB)
 	case 17: return test17_start(paramc, paramv, depc, depv);
 #endif
+	case 18: return test18_start(1, &test_arg, depc, depv);
+#if (TEST_DB_ALLOCATORS)
+	case 19: return test19_start(1, &test_arg, depc, depv);
+#endif
+	case 20: return test20_start(1, &test_arg, depc, depv);
+	case 21: return test21_start(1, &test_arg, depc, depv);
 	}
 	std::cout << "Invalid test number" << std::endl;
 	ocrShutdown();
@@ -1804,5 +2124,17 @@ extern "C" void registerEdtFunctions()
 	ocrRegisterEdtFuntion(test17_read);
 	ocrRegisterEdtFuntion(test17_terminate);
 #endif
+	ocrRegisterEdtFuntion(test18_node);
+	ocrRegisterEdtFuntion(test18_done);
+#if (TEST_DB_ALLOCATORS)
+	ocrRegisterEdtFuntion(test19_alloc);
+	ocrRegisterEdtFuntion(test19_free);
+	ocrRegisterEdtFuntion(test19_phase);
+	ocrRegisterEdtFuntion(test19_done);
+#endif
+	ocrRegisterEdtFuntion(test20_work);
+	ocrRegisterEdtFuntion(test21_work);
+	ocrRegisterEdtFuntion(test21_phase);
+	ocrRegisterEdtFuntion(test21_done);
 }
 #endif
@@ -54,12 +54,12 @@ namespace ocr_tbb
 		{
 			logging::log::event("task-execute")(edt_->guid());
 			//assert(is_not_locked(edt_->mutex_)); - can still be locked if whoever spawned it has not yet managed to release the lock
-			std::vector<ocrEdtDep_t> dep_vals(edt_->get_preslot_count());
-			std::vector<access_mode_t> dep_modes(edt_->get_preslot_count());
+			memory::slots<ocrEdtDep_t>::vector dep_vals(edt_->get_preslot_count());
+			memory::slots<access_mode_t>::vector dep_modes(edt_->get_preslot_count());
 			for (u32 i = 0; i < edt_->get_preslot_count(); ++i)
 			{
 				dep_vals[i].guid = edt_->get_preslot_data(i).as_ocr_guid();
-				dep_vals[i].ptr = (edt_->get_preslot_data(i)) ? guided::from_guid(edt_->get_preslot_data(i))->as_db()->ptr() : 0;
+				dep_vals[i].ptr = (edt_->get_preslot_data(i)) ? guided::from_guid(edt_->get_preslot_data(i))->as_db()->acquire_ptr() : 0;
 				if (edt_->get_preslot_data(i)) edt_->add_db(guided::from_guid(edt_->get_preslot_data(i))->as_db(), edt_->get_preslot_mode(i));
 				dep_modes[i] = edt_->get_preslot_mode(i);
 			}
@@ -99,6 +99,10 @@ namespace ocr_tbb
 			edt_->is_destroyed_ = true;
 			//std::cout << "barrier still has " << runtime::get().barrier->ref_count() << " predecessors" << std::endl;
 #if(DELETE_OCR_STRUCTURES)
+			{
+				//a thread that made the EDT runnable may still be holding its lock (see the assert above), the memory must not be reused before it lets go
+				tbb::spin_mutex::scoped_lock lock(edt_->wfg_node_data_.mutex);
+			}
 			delete edt_;
 #endif
 			return 0;
@@ -123,6 +127,9 @@ namespace ocr_tbb
 	edt::edt(edt_template* t, u32 paramc, u64* paramv, u32 depc, ocrGuid_t *depv, u16 properties, ocrHint_t* xhint, event* e) : node(G_edt, depc == EDT_PARAM_DEF ? t->depc_ : depc), func_(t->func_), template_guid(t->guid()), is_destroyed_(false), finish_for_children_(NULL_GUID), properties(properties)
 	{
 		DEBUG_COUT("new EDT " << guid_out(guid()) << ", function: " << (t->name_ ? t->name_ : (const char*)"[anon]"));
+#if (COUNT_ALLOCATIONS)
+		++memory::allocation_counter::edts();
+#endif
 		if (xhint) hint = *xhint;
 		else ocrHintInit(&hint, OCR_HINT_EDT_T);
 		if (paramc == EDT_PARAM_DEF && t->paramc_ == EDT_PARAM_UNK) assert(0);
@@ -130,7 +137,11 @@ namespace ocr_tbb
 		if (paramc == EDT_PARAM_DEF) paramc = t->paramc_;
 		if (paramv)
 		{
+#if (INLINE_SLOTS)
+			params_.assign(paramv, paramv + paramc);
+#else
 			std::vector<u64>(paramv, paramv + paramc).swap(params_);
+#endif
 		}
 		if (depc == EDT_PARAM_DEF) depc = t->depc_;
 		if (t->func_)//don't do this for fake tasks
@@ -161,7 +172,7 @@ namespace ocr_tbb
 			}
 		}
 #if(USE_PLAN)
-		performance_modeling::affinity_provider::initialize_guide_data(runtime::get().get_my_edt(), *this);
+		if (options::get().use_plan) performance_modeling::affinity_provider::initialize_guide_data(runtime::get().get_my_edt(), *this);
 #endif
 		if (depc == 0 && !is_fake())
 		{
@@ -207,7 +218,7 @@ namespace ocr_tbb
 		u64 aff = 0;
 		ocrGetHintValue(&hint, OCR_HINT_EDT_AFFINITY, &aff);
 #if(USE_PLAN)
-		aff = performance_modeling::affinity_provider::get_task_affinity(*this, aff);
+		if (options::get().use_plan) aff = performance_modeling::affinity_provider::get_task_affinity(*this, aff);
 #endif
 		tasking::scheduler::spawn(*tasking::task_factory<edt_task>::additional_child_of(runtime::get().barrier,this), aff);
 	}
@@ -247,6 +258,14 @@ namespace ocr_tbb
 
 	/*static*/ void* memory::manager::allocate_db_buffer(std::size_t size, std::size_t allignment, std::size_t padding, u64 affinity)
 	{
+#if (HUGE_PAGES)
+		//the NUMA-aware allocators map large buffers themselves, to bind them to the node
+		if (options::get().allocator_int == 0 && huge_pages::applies(size + allignment + padding)) return huge_pages::map(size + allignment + padding);
+#endif
+#if (ALLOCATOR_INT!=0)
+		//the internal allocator may have been switched off when the program started
+		if (options::get().allocator_int == 0) return the().malloc(size, allignment, padding);
+#endif
 #if (ALLOCATOR_INT==0)
 		return the().malloc(size, allignment, padding);
 #endif
@@ -259,6 +278,20 @@ namespace ocr_tbb
 	}
 	/*static*/ void memory::manager::free_db_buffer(void* ptr, std::size_t size, std::size_t allignment, std::size_t padding)
 	{
+#if (HUGE_PAGES)
+		if (options::get().allocator_int == 0 && huge_pages::applies(size + allignment + padding))
+		{
+			huge_pages::unmap(ptr, size + allignment + padding);
+			return;
+		}
+#endif
+#if (ALLOCATOR_INT!=0)
+		if (options::get().allocator_int == 0)
+		{
+			the().free(ptr);
+			return;
+		}
+#endif
 #if (ALLOCATOR_INT==0)
 		the().free(ptr);
 #endif
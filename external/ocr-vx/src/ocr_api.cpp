@@ -191,9 +191,8 @@ u8 ocrEdtTemplateDestroy(ocrGuid_t guid)
 u8 ocrDbCreate(ocrGuid_t *db, void** addr, u64 len, u16 flags,
 	ocrHint_t* hint, ocrInDbAllocator_t allocator)
 {
-#if(IGNORE_APP_HINTS==2 || IGNORE_APP_HINTS==3)
-	hint = 0;
-#endif
+	int ignore_app_hints = ocr_tbb::options::get().ignore_app_hints;
+	if (ignore_app_hints == 2 || ignore_app_hints == 3) hint = 0;
 	u64 aff = 0;
 	if (hint)
 	{
@@ -201,7 +200,7 @@ u8 ocrDbCreate(ocrGuid_t *db, void** addr, u64 len, u16 flags,
 		if (ocrGetHintValue(hint, OCR_HINT_DB_AFFINITY, &aff) == 0) {}
 	}
 #if(USE_PLAN)
-	aff = ocr_tbb::performance_modeling::affinity_provider::get_db_affinity(aff);
+	if (ocr_tbb::options::get().use_plan) aff = ocr_tbb::performance_modeling::affinity_provider::get_db_affinity(aff);
 #endif
 	ocr_tbb::db* res(new ocr_tbb::db(len, allocator, flags != DB_PROP_NO_ACQUIRE, aff));
 #if(CHECKED)
@@ -296,9 +295,8 @@ u8 ocrEdtCreate(ocrGuid_t * guid, ocrGuid_t templateGuid,
 		if (outputEvent) *outputEvent = nop_guid();
 		return 0;
 	}
-#if(IGNORE_APP_HINTS==1 || IGNORE_APP_HINTS==3)
-	hint = 0;
-#endif
+	int ignore_app_hints = ocr_tbb::options::get().ignore_app_hints;
+	if (ignore_app_hints == 1 || ignore_app_hints == 3) hint = 0;
 	ocrHint_t local_hint;
 	if (hint == 0)
 	{
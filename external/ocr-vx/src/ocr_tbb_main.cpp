@@ -59,6 +59,15 @@ void killer()
 
 int main(int argc, char* argv[])
 {
+	try
+	{
+		argc = ocr_tbb::options::get().parse(argc, argv);
+	}
+	catch (const text_exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	print_config();
 	for (int i = 1; i < argc;)
 	{
@@ -76,7 +85,7 @@ int main(int argc, char* argv[])
 			++i;
 		}
 	}
-	int num_threads = tbb::task_scheduler_init::default_num_threads() / CORE_REDUCTION_FACTOR;
+	int num_threads = tbb::task_scheduler_init::default_num_threads() / ocr_tbb::options::get().core_reduction_factor;
 	std::vector<char*> new_argv;
 	new_argv.reserve(argc);
 	new_argv.push_back(argv[0]);
@@ -110,6 +119,12 @@ int main(int argc, char* argv[])
 	ocr_tbb::logging::log::start();
 	ocr_tbb::tasking::scheduler::spawn_root_and_wait(*ocr_tbb::tasking::task_factory<spawn_main>::root());
 	ocr_tbb::logging::log::stop();
+#if (HUGE_PAGES)
+	ocr_tbb::memory::huge_pages::print_summary();
+#endif
+#if (COUNT_ALLOCATIONS)
+	ocr_tbb::memory::allocation_counter::print_summary();
+#endif
 
 #ifdef WIN32
 	ocr_tbb::logging::log::dump("log/", 0);
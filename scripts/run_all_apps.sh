@@ -5,7 +5,7 @@
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
 
-export artsConfig="$SCRIPT_DIR/arts.cfg"
+export artsConfig="${artsConfig:-$SCRIPT_DIR/arts.cfg}"
 export LD_LIBRARY_PATH="$PROJECT_ROOT/install/lib:$LD_LIBRARY_PATH"
 
 APPS_ROOT="$PROJECT_ROOT/external/ocr-apps/apps"
@@ -15,25 +15,356 @@ SKIPPED=0
 FAILED_APPS=""
 SKIPPED_APPS=""
 
-# Mode: "debug" (verbose) or "benchmark" (timing, minimal output)
+# Mode: "debug" (verbose), "benchmark" (timing, minimal output) or
+# "compare" (check a results file against a baseline, run nothing)
 MODE="${1:-debug}"
+[[ $# -gt 0 ]] && shift
+
+# Benchmark records: one per app run, appended so the file keeps history.
+# A .csv file gets CSV rows, anything else one JSON object per line.
+RESULT_FILE="$PROJECT_ROOT/bench_results.jsonl"
+BASELINE_FILE=""
+# Smallest mean slowdown reported as a regression (fraction)
+REL_TOL="0.05"
+# Benchmark mode: timed runs per app, preceded by untimed warm-up runs
+REPEATS=1
+WARMUP=0
+# Benchmark mode: CPU list for taskset, and what to run before every run
+PIN_CPUS=""
+DROP_CACHES=false
+PRE_RUN_HOOK=""
+# Benchmark mode: hardware counters per run through tools/perf_counters.c
+COUNTERS=false
+PERF_COUNTERS="${PERF_COUNTERS:-$PROJECT_ROOT/install/bin/perf_counters}"
+COUNTER_NAMES="cycles instructions llc_misses branch_misses context_switches"
+# Apps to run (executable names, empty = all) and per-app argument overrides
+SELECTED_APPS=""
+declare -A ARGS_OVERRIDE
 
 # Arrays to store benchmark results
 declare -a BENCH_APPS
 declare -a BENCH_TIMES
 declare -a BENCH_STATUS
+declare -a BENCH_STATS
+declare -a BENCH_COUNTERS
 
 usage() {
-    echo "Usage: $0 [debug|benchmark]"
+    echo "Usage: $0 [debug|benchmark] [-o <results>] [-b <baseline>] [-t <tol>]"
+    echo "                 [-r <reps>] [-w <warmup>] [-p <cpus>] [-D] [-H <cmd>]"
+    echo "                 [-P] [-a \"<apps>\"] [-A <app>=<args>]..."
+    echo "       $0 compare -b <baseline> [-o <results>] [-t <tol>]"
     echo "  debug     - Verbose output with detailed logs (default)"
-    echo "  benchmark - Measure execution time, minimal output, show results table"
+    echo "  benchmark - Measure execution time, minimal output, show results table;"
+    echo "              append one record per run to the results file"
+    echo "  compare   - Compare the last run in the results file against a baseline"
+    echo "  -o <file>   Results file, .csv or JSON lines (default: $RESULT_FILE)"
+    echo "  -b <file>   Baseline results file; benchmark mode compares after running"
+    echo "  -t <tol>    Minimum slowdown counted as a regression (default: $REL_TOL)"
+    echo "  -r <reps>   Timed runs per app in benchmark mode (default: $REPEATS)"
+    echo "  -w <n>      Untimed warm-up runs per app before the timed ones (default: $WARMUP)"
+    echo "  -p <cpus>   Run apps under 'taskset -c <cpus>' (ARTS pinStride still places workers)"
+    echo "  -D          Drop the page cache before every run (needs root)"
+    echo "  -H <cmd>    Shell command to run before every run"
+    echo "  -P          Record cycles, instructions, LLC misses, branch misses and context"
+    echo "              switches per run (perf_event; needs the perf_counters tool)"
+    echo "  -a \"<apps>\" Only run these executables (default: all)"
+    echo "  -A <app>=<args>  Run <app> with <args> instead of its listed ones (repeatable)"
+    echo "Set artsConfig in the environment to use another config (default: $artsConfig)."
+    echo "Exit status is 1 if any app failed or regressed, 0 otherwise."
     exit 1
 }
 
-if [[ "$MODE" != "debug" && "$MODE" != "benchmark" ]]; then
+if [[ "$MODE" != "debug" && "$MODE" != "benchmark" && "$MODE" != "compare" ]]; then
+    usage
+fi
+
+while getopts "o:b:t:r:w:p:DH:Pa:A:h" opt; do
+    case $opt in
+        o) RESULT_FILE="$OPTARG" ;;
+        b) BASELINE_FILE="$OPTARG" ;;
+        t) REL_TOL="$OPTARG" ;;
+        r) REPEATS="$OPTARG" ;;
+        w) WARMUP="$OPTARG" ;;
+        p) PIN_CPUS="$OPTARG" ;;
+        D) DROP_CACHES=true ;;
+        H) PRE_RUN_HOOK="$OPTARG" ;;
+        P) COUNTERS=true ;;
+        a) SELECTED_APPS="$OPTARG" ;;
+        A) ARGS_OVERRIDE["${OPTARG%%=*}"]="${OPTARG#*=}" ;;
+        *) usage ;;
+    esac
+done
+
+if ! [[ "$REPEATS" =~ ^[1-9][0-9]*$ && "$WARMUP" =~ ^[0-9]+$ ]]; then
+    echo "Error: -r needs a positive count and -w a count >= 0"
+    exit 1
+fi
+
+# Debug mode is for looking at output, not timing it
+if [[ "$MODE" == "debug" ]]; then
+    REPEATS=1
+    WARMUP=0
+    COUNTERS=false
+fi
+
+# Counters are best effort: without the tool, or with counters the kernel
+# refuses (no PMU in a VM, perf_event_paranoid), runs go ahead and the
+# missing values are recorded as null
+if [[ "$COUNTERS" == "true" ]]; then
+    probe="$(mktemp)"
+    if [ ! -x "$PERF_COUNTERS" ]; then
+        echo "Warning: $PERF_COUNTERS not found (build the perf_counters target), -P has no effect" >&2
+        COUNTERS=false
+    elif ! "$PERF_COUNTERS" -o "$probe" -- true; then
+        echo "Warning: $PERF_COUNTERS does not work here, -P has no effect" >&2
+        COUNTERS=false
+    else
+        unavailable="$(sed -n 's/^\([a-z_]*\)=$/\1/p' "$probe" | tr '\n' ' ')"
+        if [[ -n "$unavailable" ]]; then
+            echo "Warning: counters unavailable, recorded as null: $unavailable" >&2
+        fi
+    fi
+    rm -f "$probe"
+fi
+
+RUN_PREFIX=()
+if [[ -n "$PIN_CPUS" ]]; then
+    if ! command -v taskset > /dev/null; then
+        echo "Error: -p needs taskset (util-linux)"
+        exit 1
+    fi
+    RUN_PREFIX=(taskset -c "$PIN_CPUS")
+fi
+
+if [[ "$MODE" == "compare" && -z "$BASELINE_FILE" ]]; then
     usage
 fi
 
+# run_app changes into each app's directory
+[[ "$RESULT_FILE" == /* ]] || RESULT_FILE="$PWD/$RESULT_FILE"
+[[ -z "$BASELINE_FILE" || "$BASELINE_FILE" == /* ]] || BASELINE_FILE="$PWD/$BASELINE_FILE"
+
+#==============================================================================
+# Benchmark records
+#==============================================================================
+
+# Fields shared by every record of this invocation
+RUN_TIMESTAMP="$(date -u +%Y-%m-%dT%H:%M:%SZ)"
+GIT_REVISION="$(git -C "$PROJECT_ROOT" rev-parse --short HEAD 2>/dev/null || echo unknown)"
+if [[ "$GIT_REVISION" != "unknown" ]] && ! git -C "$PROJECT_ROOT" diff --quiet HEAD 2>/dev/null; then
+    GIT_REVISION="$GIT_REVISION-dirty"
+fi
+
+# Value of key=<n> in the ARTS config file (first match, comments skipped)
+arts_cfg_value() {
+    sed -n "s/^[[:space:]]*$1[[:space:]]*=[[:space:]]*\([^[:space:]#]*\).*/\1/p" "$artsConfig" 2>/dev/null | head -n1
+}
+
+ARTS_CONFIG="threads=$(arts_cfg_value threads);tMT=$(arts_cfg_value tMT);nodeCount=$(arts_cfg_value nodeCount)"
+
+json_escape() {
+    local s="$1"
+    s="${s//\\/\\\\}"
+    s="${s//\"/\\\"}"
+    printf '%s' "$s"
+}
+
+# First number after '=' or ':' on the first line mentioning a figure of merit,
+# as a JSON number: "+3" becomes "3" and ".5" becomes "0.5"
+parse_fom() {
+    grep -i -m1 -E 'FOM|figure of merit' "$1" 2>/dev/null |
+        sed -E 's/^[^=:]*[=:]//' | grep -o -m1 -E '[-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?' | head -n1 |
+        sed -E 's/^\+//; s/^(-?)\./\10./'
+}
+
+# write_record <app> <dir> <args> <wall_s|""> <fom|""> <status> [<rep> <outlier> <counters>]
+# <counters> is comma-separated, in COUNTER_NAMES order, empty if not counted
+write_record() {
+    local app="$1" dir="$2" args="$3" wall="$4" fom="$5" status="$6"
+    local rep="${7:-1}" outlier="${8:-false}" counters="${9:-,,,,}"
+
+    if [[ "$RESULT_FILE" == *.csv ]]; then
+        if [ ! -s "$RESULT_FILE" ]; then
+            echo "timestamp,revision,app,dir,args,config,wall_s,fom,status,rep,outlier,${COUNTER_NAMES// /,}" > "$RESULT_FILE"
+        fi
+        # Args may contain commas; quote them and double embedded quotes
+        printf '%s,%s,%s,%s,"%s",%s,%s,%s,%s,%s,%s,%s\n' "$RUN_TIMESTAMP" "$GIT_REVISION" "$app" "$dir" \
+            "${args//\"/\"\"}" "$ARTS_CONFIG" "$wall" "$fom" "$status" "$rep" "$outlier" \
+            "$counters" >> "$RESULT_FILE"
+    else
+        local name value json_counters=""
+        local -a values=()
+        IFS=, read -r -a values <<< "$counters,"
+        local i=0
+        for name in $COUNTER_NAMES; do
+            value="${values[$i]}"
+            json_counters="$json_counters,\"$name\":${value:-null}"
+            i=$((i + 1))
+        done
+        printf '{"timestamp":"%s","revision":"%s","app":"%s","dir":"%s","args":"%s","config":"%s","wall_s":%s,"fom":%s,"status":"%s","rep":%s,"outlier":%s%s}\n' \
+            "$RUN_TIMESTAMP" "$GIT_REVISION" "$(json_escape "$app")" "$(json_escape "$dir")" \
+            "$(json_escape "$args")" "$ARTS_CONFIG" "${wall:-null}" "${fom:-null}" "$status" \
+            "$rep" "$outlier" "$json_counters" >> "$RESULT_FILE"
+    fi
+}
+
+# Comma-separated counter values (COUNTER_NAMES order) from a perf_counters file
+parse_counters() {
+    local name sep="" line=""
+    for name in $COUNTER_NAMES; do
+        line="$line$sep$(sed -n "s/^$name=//p" "$1" 2>/dev/null)"
+        sep=","
+    done
+    echo "$line"
+}
+
+# counter_summary <counters>... prints the per-counter medians of the runs
+# (blank counters skipped) as one table row: Gcycles, Ginstructions, IPC,
+# M LLC misses, M branch misses, context switches
+counter_summary() {
+    printf '%s\n' "$@" | awk -F, '
+        function median(c,    n, i, j, s, t) {
+            n = 0
+            for (i = 1; i <= NR; i++) if (v[i, c] != "") s[++n] = v[i, c]
+            if (n == 0) return ""
+            for (i = 2; i <= n; i++)
+                for (j = i; j > 1 && s[j - 1] > s[j]; j--) { t = s[j]; s[j] = s[j - 1]; s[j - 1] = t }
+            return (n % 2) ? s[(n + 1) / 2] : (s[n / 2] + s[n / 2 + 1]) / 2
+        }
+        function show(x, scale, fmt) { return (x == "") ? "-" : sprintf(fmt, x / scale) }
+        { for (c = 1; c <= 5; c++) v[NR, c] = ($c == "") ? "" : $c + 0 }
+        END {
+            cyc = median(1); ins = median(2)
+            ipc = (cyc != "" && ins != "" && cyc > 0) ? sprintf("%.2f", ins / cyc) : "-"
+            printf "%10s %10s %6s %10s %10s %10s", show(cyc, 1e9, "%.3f"), show(ins, 1e9, "%.3f"), ipc,
+                   show(median(3), 1e6, "%.3f"), show(median(4), 1e6, "%.3f"), show(median(5), 1, "%.0f")
+        }'
+}
+
+#==============================================================================
+# Repetitions
+#==============================================================================
+
+DROP_CACHES_WARNED=false
+
+# Runs before every execution, warm-ups included, so each starts from the
+# same state
+before_run() {
+    if [[ "$DROP_CACHES" == "true" ]]; then
+        sync
+        if ! { echo 3 > /proc/sys/vm/drop_caches; } 2>/dev/null && [[ "$DROP_CACHES_WARNED" == "false" ]]; then
+            echo "Warning: cannot write /proc/sys/vm/drop_caches, -D has no effect" >&2
+            DROP_CACHES_WARNED=true
+        fi
+    fi
+    if [[ -n "$PRE_RUN_HOOK" ]]; then
+        eval "$PRE_RUN_HOOK" > /dev/null 2>&1 || echo "Warning: -H hook failed: $PRE_RUN_HOOK" >&2
+    fi
+}
+
+# rep_stats <t1> <t2> ... prints one line:
+#   <n> <median> <min> <stddev> <ci95_lo> <ci95_hi> <outlier flags>
+# Outliers have a modified z-score (0.6745 |t - median| / MAD) above 3.5,
+# with the mean absolute deviation standing in when the MAD is 0; they
+# need at least 3 runs and to be more than 2% off the median, so timer
+# noise between near-identical runs is not flagged. Outliers are left out
+# of the statistics, and the flags (comma-separated true/false, in run
+# order) let the caller mark them. The interval is the 95% t interval of
+# the mean.
+rep_stats() {
+    printf '%s\n' "$@" | awk '
+        function tcrit2(df) {
+            if (df < 1.5) return 12.706; if (df < 2.5) return 4.303; if (df < 3.5) return 3.182
+            if (df < 4.5) return 2.776; if (df < 5.5) return 2.571; if (df < 6.5) return 2.447
+            if (df < 7.5) return 2.365; if (df < 8.5) return 2.306; if (df < 9.5) return 2.262
+            if (df < 11) return 2.228; if (df < 13.5) return 2.179; if (df < 17.5) return 2.131
+            if (df < 25) return 2.086; if (df < 40) return 2.042; return 1.960
+        }
+        function median(v, n,    i, j, s, t) {
+            for (i = 1; i <= n; i++) s[i] = v[i]
+            for (i = 2; i <= n; i++)
+                for (j = i; j > 1 && s[j - 1] > s[j]; j--) { t = s[j]; s[j] = s[j - 1]; s[j - 1] = t }
+            return (n % 2) ? s[(n + 1) / 2] : (s[n / 2] + s[n / 2 + 1]) / 2
+        }
+        { x[++n] = $1 }
+        END {
+            med = median(x, n)
+            for (i = 1; i <= n; i++) { d[i] = (x[i] > med) ? x[i] - med : med - x[i]; mean_ad += d[i] / n }
+            mad = median(d, n)
+            scale = (mad > 0) ? mad / 0.6745 : mean_ad * 1.2533
+            flags = ""; m = 0
+            for (i = 1; i <= n; i++) {
+                out = (n >= 3 && scale > 0 && d[i] / scale > 3.5 && d[i] > 0.02 * med)
+                flags = flags (i > 1 ? "," : "") (out ? "true" : "false")
+                if (!out) y[++m] = x[i]
+            }
+            lo = y[1]
+            for (i = 1; i <= m; i++) { sum += y[i]; if (y[i] < lo) lo = y[i] }
+            mean = sum / m
+            for (i = 1; i <= m; i++) sq += (y[i] - mean) ^ 2
+            sd = (m > 1) ? sqrt(sq / (m - 1)) : 0
+            half = (m > 1) ? tcrit2(m - 1) * sd / sqrt(m) : 0
+            printf "%d %.3f %.3f %.3f %.3f %.3f %s\n", m, median(y, m), lo, sd, mean - half, mean + half, flags
+        }'
+}
+
+# run_once <install_dir> <exec_path> <args> <verify_cmd>
+# One execution of an app; sets RUN_ELAPSED, RUN_FOM and RUN_FAIL_REASON
+# (empty on success)
+run_once() {
+    local install_dir="$1" exec_path="$2" args="$3" verify_cmd="$4"
+    local log=""
+    local counters_file=""
+    local -a wrapper=()
+
+    if [[ "$COUNTERS" == "true" ]]; then
+        counters_file="$(mktemp)"
+        wrapper=("$PERF_COUNTERS" -o "$counters_file" --)
+    fi
+
+    # Clean up any output files from previous runs to avoid stale data
+    rm -f "$install_dir"/*.out "$install_dir"/*_output.txt 2>/dev/null
+    
+    # Measure wall clock time in both modes
+    local start_time=$(date +%s.%N)
+    local exec_result=0
+    
+    if [[ "$MODE" == "debug" ]]; then
+        "${RUN_PREFIX[@]}" "$exec_path" $args || exec_result=$?
+    else
+        log="$(mktemp)"
+        "${wrapper[@]}" "${RUN_PREFIX[@]}" "$exec_path" $args > "$log" 2>&1 || exec_result=$?
+    fi
+    
+    local end_time=$(date +%s.%N)
+    RUN_ELAPSED=$(awk -v s="$start_time" -v e="$end_time" 'BEGIN { printf "%.6f", e - s }')
+    RUN_FOM=""
+    RUN_COUNTERS=""
+    RUN_FAIL_REASON=""
+
+    if [[ -n "$counters_file" ]]; then
+        RUN_COUNTERS="$(parse_counters "$counters_file")"
+        rm -f "$counters_file"
+    fi
+    
+    if [[ $exec_result -ne 0 ]]; then
+        RUN_FAIL_REASON="execution error (exit code: $exec_result)"
+    elif [[ -n "$verify_cmd" ]]; then
+        # Run verification command
+        if [[ "$MODE" == "debug" ]]; then
+            echo "Running verification: $verify_cmd"
+        fi
+        if ! eval "$verify_cmd" > /dev/null 2>&1; then
+            RUN_FAIL_REASON="verification failed"
+        fi
+    fi
+
+    if [[ -n "$log" ]]; then
+        RUN_FOM="$(parse_fom "$log")"
+        rm -f "$log"
+    fi
+}
+
 run_app() {
     local app_dir="$1"
     local exec_name="$2"
@@ -58,6 +389,13 @@ run_app() {
         fi
     done
     
+    if [[ -n "$SELECTED_APPS" && " $SELECTED_APPS " != *" $exec_name "* ]]; then
+        return 0
+    fi
+    if [[ -n "${ARGS_OVERRIDE[$exec_name]+set}" ]]; then
+        args="${ARGS_OVERRIDE[$exec_name]}"
+    fi
+
     local install_dir="$APPS_ROOT/$app_dir/install/x86"
     local exec_path="$install_dir/$exec_name"
 
@@ -78,71 +416,99 @@ run_app() {
         BENCH_APPS+=("$exec_name")
         BENCH_TIMES+=("-")
         BENCH_STATUS+=("SKIPPED")
+        BENCH_STATS+=("")
+        BENCH_COUNTERS+=("")
+        [[ "$MODE" == "benchmark" ]] && write_record "$exec_name" "$app_dir" "$args" "" "" "SKIPPED"
         return 0
     fi
 
     # Change to app directory (not install dir) for relative path support
     pushd "$APPS_ROOT/$app_dir" > /dev/null
-    
-    # Clean up any output files from previous runs to avoid stale data
-    rm -f "$install_dir"/*.out "$install_dir"/*_output.txt 2>/dev/null
-    
-    # Measure wall clock time in both modes
-    local start_time=$(date +%s.%N)
-    local exec_result=0
-    
-    if [[ "$MODE" == "debug" ]]; then
-        "$exec_path" $args || exec_result=$?
-    else
-        printf "Running %-40s ... " "$exec_name"
-        "$exec_path" $args > /dev/null 2>&1 || exec_result=$?
-    fi
-    
-    local end_time=$(date +%s.%N)
-    local elapsed=$(echo "$end_time - $start_time" | bc)
-    
-    # Determine pass/fail
-    local passed=false
+
+    [[ "$MODE" == "benchmark" ]] && printf "Running %-40s ... " "$exec_name"
+
+    local runs=$((WARMUP + REPEATS))
+    local run
+    local -a times=()
+    local -a foms=()
+    local -a counters=()
+    local status="PASS"
     local fail_reason=""
-    
-    if [[ $exec_result -ne 0 ]]; then
-        fail_reason="execution error (exit code: $exec_result)"
-    elif [[ -n "$verify_cmd" ]]; then
-        # Run verification command
-        if [[ "$MODE" == "debug" ]]; then
-            echo "Running verification: $verify_cmd"
+    local elapsed=""
+
+    for ((run = 1; run <= runs; run++)); do
+        before_run
+        run_once "$install_dir" "$exec_path" "$args" "$verify_cmd"
+        elapsed="$RUN_ELAPSED"
+
+        if [[ -n "$RUN_FAIL_REASON" ]]; then
+            status="FAIL"
+            fail_reason="$RUN_FAIL_REASON"
+            if [[ $run -gt $WARMUP ]]; then
+                fail_reason="$fail_reason, run $((run - WARMUP)) of $REPEATS"
+            else
+                fail_reason="$fail_reason, warm-up run $run"
+            fi
+            break
         fi
-        if eval "$verify_cmd" > /dev/null 2>&1; then
-            passed=true
-        else
-            fail_reason="verification failed"
+        if [[ $run -gt $WARMUP ]]; then
+            times+=("$elapsed")
+            foms+=("$RUN_FOM")
+            counters+=("$RUN_COUNTERS")
         fi
-    else
-        passed=true
-    fi
-    
+    done
+
     # Report results
-    if [[ "$passed" == "true" ]]; then
+    if [[ "$status" == "PASS" ]]; then
+        local stats n median min sd ci_lo ci_hi flags
+        stats="$(rep_stats "${times[@]}")"
+        read -r n median min sd ci_lo ci_hi flags <<< "$stats"
+        local -a outlier=()
+        IFS=, read -r -a outlier <<< "$flags"
+        local num_outliers=$((REPEATS - n))
+
         if [[ "$MODE" == "debug" ]]; then
             printf "SUCCESS: %s completed (%.3fs)\n" "$exec_name" "$elapsed"
-        else
+        elif [[ $REPEATS -eq 1 ]]; then
             printf "PASS (%.3fs)\n" "$elapsed"
+        else
+            printf "PASS (median %.3fs, %d runs%s)\n" "$median" "$REPEATS" \
+                "$([[ $num_outliers -gt 0 ]] && echo ", $num_outliers outlier(s)")"
         fi
         PASSED=$((PASSED + 1))
         BENCH_APPS+=("$exec_name")
-        BENCH_TIMES+=("$(printf "%.3f" "$elapsed")")
+        BENCH_TIMES+=("$median")
         BENCH_STATUS+=("PASS")
+        BENCH_STATS+=("$(printf "%9s %9s %19s %4s" "$min" "$sd" "[$ci_lo, $ci_hi]" "$num_outliers")")
+        if [[ "$COUNTERS" == "true" ]]; then
+            BENCH_COUNTERS+=("$(counter_summary "${counters[@]}")")
+        else
+            BENCH_COUNTERS+=("")
+        fi
+
+        if [[ "$MODE" == "benchmark" ]]; then
+            for ((run = 0; run < REPEATS; run++)); do
+                write_record "$exec_name" "$app_dir" "$args" "$(printf "%.3f" "${times[$run]}")" \
+                    "${foms[$run]}" "PASS" "$((run + 1))" "${outlier[$run]}" "${counters[$run]}"
+            done
+        fi
     else
         if [[ "$MODE" == "debug" ]]; then
             printf "FAILED: %s - %s (%.3fs)\n" "$exec_name" "$fail_reason" "$elapsed"
         else
-            printf "FAIL (%.3fs)\n" "$elapsed"
+            printf "FAIL (%.3fs, %s)\n" "$elapsed" "$fail_reason"
         fi
         FAILED=$((FAILED + 1))
         FAILED_APPS="$FAILED_APPS $exec_name"
         BENCH_APPS+=("$exec_name")
         BENCH_TIMES+=("$(printf "%.3f" "$elapsed")")
         BENCH_STATUS+=("FAIL")
+        BENCH_STATS+=("")
+        BENCH_COUNTERS+=("")
+
+        # Only the failing run is recorded; passing runs before it are dropped
+        [[ "$MODE" == "benchmark" ]] && write_record "$exec_name" "$app_dir" "$args" \
+            "$(printf "%.3f" "$elapsed")" "" "FAIL" "$((${#times[@]} + 1))" "false" "$RUN_COUNTERS"
     fi
     
     # Restore original directory
@@ -153,6 +519,163 @@ run_app() {
     fi
 }
 
+#==============================================================================
+# Regression check against a baseline
+#==============================================================================
+
+# Groups both files' records by app, directory, args and ARTS config, then
+# compares wall times of passing runs. The results file keeps history, so only
+# the records of one run (timestamp and revision, by default its last run)
+# are taken from it; the baseline is taken whole. With two or more runs on each side, a slowdown is a
+# regression when it is at least REL_TOL and Welch's t-test rejects "no
+# slowdown" at 95% (one-sided). With a single run on either side there is no
+# variance estimate, and the REL_TOL threshold alone decides. Runs marked
+# as outliers are left out, as in the benchmark statistics. A run that
+# passed in the baseline and fails now is always a regression. Prints a
+# table and returns the number of regressions.
+# compare_results <baseline> <current> [<timestamp> <revision>]
+compare_results() {
+    local baseline="$1"
+    local current="$2"
+    local run_timestamp="${3:-}" run_revision="${4:-}"
+
+    if [ ! -s "$baseline" ] || [ ! -s "$current" ]; then
+        echo "compare: missing or empty results file ($baseline, $current)"
+        return 1
+    fi
+
+    awk -v tol="$REL_TOL" -v run_ts="$run_timestamp" -v run_rev="$run_revision" '
+        function field(line, key,    m) {
+            if (match(line, "\"" key "\":\"([^\"\\\\]|\\\\.)*\"")) {
+                m = substr(line, RSTART + length(key) + 4, RLENGTH - length(key) - 5)
+                gsub(/\\"/, "\"", m); gsub(/\\\\/, "\\", m)
+                return m
+            }
+            if (match(line, "\"" key "\":[^,}]*")) {
+                m = substr(line, RSTART + length(key) + 3, RLENGTH - length(key) - 3)
+                return (m == "null") ? "" : m
+            }
+            return ""
+        }
+        # CSV rows written by write_record: only the args column is quoted
+        function parse_csv(line, rec,    n, pre, post) {
+            match(line, /,"([^"]|"")*",/)
+            pre = substr(line, 1, RSTART - 1)
+            rec["args"] = substr(line, RSTART + 2, RLENGTH - 4)
+            gsub(/""/, "\"", rec["args"])
+            post = substr(line, RSTART + RLENGTH)
+            split(pre, a, ","); split(post, b, ",")
+            rec["timestamp"] = a[1]; rec["revision"] = a[2]; rec["app"] = a[3]; rec["dir"] = a[4]
+            rec["config"] = b[1]; rec["wall_s"] = b[2]; rec["status"] = b[4]; rec["outlier"] = b[6]
+        }
+        function add(side, key, status, outlier, wall) {
+            if (!(key in seen)) { seen[key] = 1; order[++nkeys] = key }
+            if (status == "PASS" && outlier != "true") {
+                n[side, key]++; sum[side, key] += wall; sq[side, key] += wall * wall
+            } else if (status == "FAIL") {
+                fail[side, key]++
+            }
+        }
+        # t(0.95, df), one-sided
+        function tcrit(df) {
+            if (df < 1.5) return 6.314; if (df < 2.5) return 2.920; if (df < 3.5) return 2.353
+            if (df < 4.5) return 2.132; if (df < 5.5) return 2.015; if (df < 6.5) return 1.943
+            if (df < 7.5) return 1.895; if (df < 8.5) return 1.860; if (df < 9.5) return 1.833
+            if (df < 11) return 1.812; if (df < 13.5) return 1.782; if (df < 17.5) return 1.753
+            if (df < 25) return 1.725; if (df < 40) return 1.697; return 1.645
+        }
+        FNR == 1 { side = (++file == 1) ? "b" : "c"; csv = (FILENAME ~ /\.csv$/) }
+        csv && FNR == 1 { next }
+        /^[[:space:]]*$/ { next }
+        {
+            delete rec
+            if (csv) parse_csv($0, rec)
+            else { rec["timestamp"] = field($0, "timestamp"); rec["revision"] = field($0, "revision")
+                   rec["app"] = field($0, "app"); rec["dir"] = field($0, "dir"); rec["args"] = field($0, "args")
+                   rec["config"] = field($0, "config"); rec["wall_s"] = field($0, "wall_s")
+                   rec["status"] = field($0, "status"); rec["outlier"] = field($0, "outlier") }
+            key = rec["app"] SUBSEP rec["dir"] SUBSEP rec["args"] SUBSEP rec["config"]
+            if (side == "b") {
+                add("b", key, rec["status"], rec["outlier"], rec["wall_s"])
+            } else {
+                # Kept until the run to compare is known
+                nc_recs++
+                c_run[nc_recs] = rec["timestamp"] SUBSEP rec["revision"]; c_key[nc_recs] = key
+                c_status[nc_recs] = rec["status"]; c_outlier[nc_recs] = rec["outlier"]; c_wall[nc_recs] = rec["wall_s"]
+            }
+        }
+        END {
+            run = (run_ts != "" || run_rev != "") ? run_ts SUBSEP run_rev : c_run[nc_recs]
+            for (i = 1; i <= nc_recs; i++) {
+                if (c_run[i] != run)
+                    continue
+                add("c", c_key[i], c_status[i], c_outlier[i], c_wall[i])
+                split(c_key[i], k, SUBSEP); run_config[k[4]] = 1
+            }
+            split(run, r, SUBSEP)
+            printf "Current run: %s, revision %s\n", r[1], r[2]
+            printf "%-28s %-24s %18s %18s %8s  %s\n", "Application", "Args", "Baseline (s)", "Current (s)", "Change", "Verdict"
+            regressions = 0
+            for (i = 1; i <= nkeys; i++) {
+                key = order[i]; split(key, k, SUBSEP)
+                # Baseline runs under other ARTS configs are not comparable
+                if (!(k[4] in run_config))
+                    continue
+                args = (length(k[3]) > 24) ? substr(k[3], 1, 21) "..." : k[3]
+                nb = n["b", key] + 0; nc = n["c", key] + 0
+                if (!nb && !nc && !fail["c", key])
+                    continue
+                mb = nb ? sum["b", key] / nb : 0; mc = nc ? sum["c", key] / nc : 0
+                vb = (nb > 1) ? (sq["b", key] - nb * mb * mb) / (nb - 1) : 0
+                vc = (nc > 1) ? (sq["c", key] - nc * mc * mc) / (nc - 1) : 0
+                if (vb < 0) vb = 0; if (vc < 0) vc = 0
+                bs = nb ? sprintf("%.3f+-%.3f (%d)", mb, sqrt(vb), nb) : "-"
+                cs = nc ? sprintf("%.3f+-%.3f (%d)", mc, sqrt(vc), nc) : "-"
+                change = ""; verdict = ""
+                if (nb && nc) {
+                    rel = (mc - mb) / (mb > 0 ? mb : 1)
+                    change = sprintf("%+.1f%%", 100 * rel)
+                    if (rel >= tol) {
+                        if (nb > 1 && nc > 1) {
+                            se2 = vb / nb + vc / nc
+                            if (se2 == 0) { significant = 1; note = "" }
+                            else {
+                                t = (mc - mb) / sqrt(se2)
+                                df = se2 * se2 / ((vb / nb) ^ 2 / (nb - 1) + (vc / nc) ^ 2 / (nc - 1))
+                                significant = (t > tcrit(df)); note = sprintf(" (t=%.2f, df=%.1f)", t, df)
+                            }
+                            verdict = significant ? "REGRESSION" note : "slower, not significant" note
+                        } else {
+                            significant = 1; verdict = "REGRESSION (single run, threshold only)"
+                        }
+                        if (significant) regressions++
+                    } else if (rel <= -tol) {
+                        verdict = "faster"
+                    } else {
+                        verdict = "ok"
+                    }
+                } else if (nb && !nc && fail["c", key]) {
+                    verdict = "REGRESSION (now failing)"; regressions++
+                } else if (!nb && nc) {
+                    verdict = "new"
+                } else if (nb && !nc) {
+                    verdict = "not run"
+                } else {
+                    verdict = "failing"
+                }
+                printf "%-28s %-24s %18s %18s %8s  %s\n", substr(k[1], 1, 28), args, bs, cs, change, verdict
+            }
+            printf "Regressions: %d (tolerance %.1f%%)\n", regressions, 100 * tol
+            exit (regressions > 255 ? 255 : regressions)
+        }
+    ' "$baseline" "$current"
+}
+
+if [[ "$MODE" == "compare" ]]; then
+    compare_results "$BASELINE_FILE" "$RESULT_FILE"
+    exit $(($? > 0 ? 1 : 0))
+fi
+
 # run_app "basicIO/ocr" "basicIO" 0 10 "$APPS_ROOT/basicIO/ocr/input_10.txt" --verify diff -b "$APPS_ROOT/basicIO/ocr/input_10.txt" "$APPS_ROOT/basicIO/ocr/basicIO_output.txt"
 # run_app "basicIO/ocr" "basicIO" 0 1000000 "$APPS_ROOT/basicIO/ocr/input_1000000.txt" --verify diff -b "$APPS_ROOT/basicIO/ocr/input_1000000.txt" "$APPS_ROOT/basicIO/ocr/basicIO_output.txt"
 # run_app "cholesky/ocr" "cholesky" --ds 50 --ts 50 --fi "$APPS_ROOT/cholesky/datasets/m_50.in" --ol 1 --verify diff -b "$APPS_ROOT/cholesky/datasets/cholesky_out_50.txt" "$APPS_ROOT/cholesky/ocr/cholesky.out"
@@ -263,10 +786,19 @@ else
     echo "================================================================================"
     echo "                           BENCHMARK RESULTS"
     echo "================================================================================"
-    printf "%-40s %12s %10s\n" "Application" "Time (s)" "Status"
+    if [[ $REPEATS -eq 1 ]]; then
+        printf "%-40s %12s %10s\n" "Application" "Time (s)" "Status"
+    else
+        echo "$REPEATS timed runs per app after $WARMUP warm-up run(s); outliers excluded from the statistics"
+        printf "%-40s %12s %9s %9s %19s %4s %10s\n" "Application" "Median (s)" "Min" "Stddev" "95% CI (mean)" "Out" "Status"
+    fi
     echo "--------------------------------------------------------------------------------"
     for i in "${!BENCH_APPS[@]}"; do
-        printf "%-40s %12s %10s\n" "${BENCH_APPS[$i]}" "${BENCH_TIMES[$i]}" "${BENCH_STATUS[$i]}"
+        if [[ $REPEATS -eq 1 ]]; then
+            printf "%-40s %12s %10s\n" "${BENCH_APPS[$i]}" "${BENCH_TIMES[$i]}" "${BENCH_STATUS[$i]}"
+        else
+            printf "%-40s %12s %44s %10s\n" "${BENCH_APPS[$i]}" "${BENCH_TIMES[$i]}" "${BENCH_STATS[$i]}" "${BENCH_STATUS[$i]}"
+        fi
     done
     echo "--------------------------------------------------------------------------------"
     printf "%-40s %12s %10s\n" "TOTAL" "" "P:$PASSED F:$FAILED S:$SKIPPED"
@@ -277,5 +809,23 @@ else
     if [ $SKIPPED -gt 0 ]; then
         echo "Skipped apps:$SKIPPED_APPS"
     fi
+    if [[ "$COUNTERS" == "true" ]]; then
+        echo ""
+        echo "Hardware counters (median of timed runs, including outliers)"
+        printf "%-40s %10s %10s %6s %10s %10s %10s\n" "Application" "Gcycles" "Ginstr" "IPC" "LLC miss M" "Br miss M" "Ctx sw"
+        for i in "${!BENCH_APPS[@]}"; do
+            [[ -n "${BENCH_COUNTERS[$i]}" ]] && printf "%-40s %s\n" "${BENCH_APPS[$i]}" "${BENCH_COUNTERS[$i]}"
+        done
+    fi
+    echo "Records appended to $RESULT_FILE (revision $GIT_REVISION, $ARTS_CONFIG)"
+
+    if [[ -n "$BASELINE_FILE" ]]; then
+        echo ""
+        echo "Comparison against $BASELINE_FILE:"
+        compare_results "$BASELINE_FILE" "$RESULT_FILE" "$RUN_TIMESTAMP" "$GIT_REVISION"
+        REGRESSIONS=$?
+        # Exit statuses wrap at 256
+        exit $((FAILED + REGRESSIONS > 0 ? 1 : 0))
+    fi
 fi
-exit $FAILED
+exit $((FAILED > 0 ? 1 : 0))
@@ -0,0 +1,244 @@
+#!/bin/bash
+# Cross-variant LULESH benchmark driver
+#
+# Runs every LULESH variant over a matrix of problem sizes, iteration counts
+# and tile sizes, parses FOM / elapsed time / final origin energy from the
+# final statistics, and checks each energy against the sequential reference
+# for the same (size, iterations) point. All runs land in one CSV file.
+#
+# The sequential variant advances elapsed time and picks the first-cycle dt
+# differently from the ARTS variants, so their energies differ by up to ~1.3%
+# on short runs and a few tenths of a percent on long ones; the default
+# tolerance (-r) accounts for that. The ARTS variants (per-element, tiled,
+# optimized) compute the same steps, so each of them is also checked against
+# the first ARTS run of the point with a separate tolerance (-a), by default
+# exact at the printed precision.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+export artsConfig="${artsConfig:-$SCRIPT_DIR/arts.cfg}"
+export LD_LIBRARY_PATH="$PROJECT_ROOT/install/lib:$LD_LIBRARY_PATH"
+
+BIN_DIR="${LULESH_BIN_DIR:-$PROJECT_ROOT/install/bin}"
+
+# Executables (overridable, e.g. by the lulesh_bench CMake target)
+LULESH_SEQUENTIAL="${LULESH_SEQUENTIAL:-$BIN_DIR/lulesh_sequential}"
+LULESH_SEQUENTIAL_THREADED="${LULESH_SEQUENTIAL_THREADED:-$BIN_DIR/lulesh_sequential_threaded}"
+LULESH_PER_ELEMENT="${LULESH_PER_ELEMENT:-$BIN_DIR/lulesh}"
+LULESH_TILED="${LULESH_TILED:-$BIN_DIR/lulesh_tiled}"
+LULESH_OPTIMIZED="${LULESH_OPTIMIZED:-$BIN_DIR/lulesh_optimized}"
+
+SIZES="10 20 30"
+ITERATIONS="100"
+TILES="128 512"
+GRAINS="1"
+VARIANTS="sequential sequential_threaded per-element tiled optimized"
+REL_TOL="2e-2"
+ARTS_TOL="0"
+RESULT_FILE="$PROJECT_ROOT/lulesh_bench_results.csv"
+
+PASSED=0
+FAILED=0
+SKIPPED=0
+
+usage() {
+    echo "Usage: $0 [options]"
+    echo "  -s \"<sizes>\"      Problem sizes (default: \"$SIZES\")"
+    echo "  -i \"<iters>\"      Iteration counts (default: \"$ITERATIONS\")"
+    echo "  -T \"<tiles>\"      Tile sizes for tiled/optimized (default: \"$TILES\")"
+    echo "  -g \"<grains>\"     Items per EDT for per-element, in the tile column (default: \"$GRAINS\")"
+    echo "  -v \"<variants>\"   Variants to run (default: \"$VARIANTS\")"
+    echo "  -r <tol>          Relative energy tolerance vs sequential (default: $REL_TOL)"
+    echo "  -a <tol>          Relative energy tolerance between ARTS variants (default: $ARTS_TOL)"
+    echo "  -o <file>         Result file (default: $RESULT_FILE)"
+    exit 1
+}
+
+while getopts "s:i:T:g:v:r:a:o:h" opt; do
+    case $opt in
+        s) SIZES="$OPTARG" ;;
+        i) ITERATIONS="$OPTARG" ;;
+        T) TILES="$OPTARG" ;;
+        g) GRAINS="$OPTARG" ;;
+        v) VARIANTS="$OPTARG" ;;
+        r) REL_TOL="$OPTARG" ;;
+        a) ARTS_TOL="$OPTARG" ;;
+        o) RESULT_FILE="$OPTARG" ;;
+        *) usage ;;
+    esac
+done
+
+variant_exec() {
+    case "$1" in
+        sequential)          echo "$LULESH_SEQUENTIAL" ;;
+        sequential_threaded) echo "$LULESH_SEQUENTIAL_THREADED" ;;
+        per-element)         echo "$LULESH_PER_ELEMENT" ;;
+        tiled)               echo "$LULESH_TILED" ;;
+        optimized)           echo "$LULESH_OPTIMIZED" ;;
+    esac
+}
+
+variant_is_arts() {
+    [[ "$1" == "per-element" || "$1" == "tiled" || "$1" == "optimized" ]]
+}
+
+variant_is_tiled() {
+    [[ "$1" == "tiled" || "$1" == "optimized" ]]
+}
+
+# Per-variant granularity option and the values swept for it
+variant_grain_flag() {
+    if variant_is_tiled "$1"; then
+        echo "-T"
+    elif [[ "$1" == "per-element" ]]; then
+        echo "-g"
+    fi
+}
+
+variant_grains() {
+    if variant_is_tiled "$1"; then
+        echo "$TILES"
+    elif [[ "$1" == "per-element" ]]; then
+        echo "$GRAINS"
+    fi
+}
+
+# rel_err <energy> <reference>
+rel_err() {
+    awk -v e="$1" -v r="$2" \
+        'BEGIN { d = e - r; if (d < 0) d = -d; if (r < 0) r = -r; printf "%.3e", (r > 0) ? d / r : d }'
+}
+
+within() {
+    awk -v x="$1" -v t="$2" 'BEGIN { exit !(x <= t) }'
+}
+
+# Extract the value following '=' on the first line matching a label
+parse_stat() {
+    local label="$1"
+    local file="$2"
+    grep -m1 "$label" "$file" | sed 's/.*=[[:space:]]*//' | awk '{print $1}'
+}
+
+# run_variant <variant> <size> <iters> <tile|-> <reference energy|-> [<ARTS reference energy|->]
+# Leaves the parsed origin energy in LAST_ENERGY (empty unless the run
+# passed) so the sequential run and the first ARTS run can serve as the
+# references.
+run_variant() {
+    local variant="$1"
+    local size="$2"
+    local iters="$3"
+    local tile="$4"
+    local ref_energy="$5"
+    local arts_energy="${6:--}"
+    local exec_path
+    exec_path="$(variant_exec "$variant")"
+    LAST_ENERGY=""
+
+    local args="-q -s $size -i $iters"
+    if [[ "$tile" != "-" ]]; then
+        args="$args $(variant_grain_flag "$variant") $tile"
+    fi
+
+    printf "Running %-20s s=%-4s i=%-6s T=%-5s ... " "$variant" "$size" "$iters" "$tile"
+
+    if [ ! -x "$exec_path" ]; then
+        echo "SKIPPED (not found: $exec_path)"
+        SKIPPED=$((SKIPPED + 1))
+        echo "$variant,$size,$iters,$tile,,,,,,$ref_energy,,,,SKIPPED" >> "$RESULT_FILE"
+        return 0
+    fi
+
+    local log
+    log="$(mktemp)"
+    local start_time=$(date +%s.%N)
+    local exec_result=0
+    "$exec_path" $args > "$log" 2>&1 || exec_result=$?
+    local end_time=$(date +%s.%N)
+    local wall=$(awk -v a="$start_time" -v b="$end_time" 'BEGIN { printf "%.3f", b - a }')
+
+    local iter_count=$(parse_stat "Iteration count" "$log")
+    local elapsed=$(parse_stat "Elapsed time" "$log")
+    local fom=$(parse_stat "FOM" "$log")
+    local energy=$(parse_stat "Final Origin Energy" "$log")
+    rm -f "$log"
+
+    local err="" arts_err=""
+    local status="PASS"
+    if [[ $exec_result -ne 0 || -z "$energy" ]]; then
+        status="FAIL"
+    else
+        if [[ "$ref_energy" != "-" ]]; then
+            err=$(rel_err "$energy" "$ref_energy")
+            within "$err" "$REL_TOL" || status="DIVERGED"
+        fi
+        if [[ "$arts_energy" != "-" ]]; then
+            arts_err=$(rel_err "$energy" "$arts_energy")
+            [[ "$status" == "PASS" ]] && ! within "$arts_err" "$ARTS_TOL" && status="MISMATCH"
+        fi
+    fi
+
+    if [[ "$status" == "PASS" ]]; then
+        PASSED=$((PASSED + 1))
+        printf "PASS (%ss, FOM %s)\n" "$wall" "$fom"
+    else
+        FAILED=$((FAILED + 1))
+        printf "%s (exit %d, energy %s, rel err %s, vs ARTS %s)\n" "$status" "$exec_result" "$energy" \
+            "${err:--}" "${arts_err:--}"
+    fi
+
+    echo "$variant,$size,$iters,$tile,$iter_count,$wall,$elapsed,$fom,$energy,$ref_energy,$err,${arts_energy#-},$arts_err,$status" >> "$RESULT_FILE"
+
+    if [[ "$status" == "PASS" ]]; then
+        LAST_ENERGY="$energy"
+    fi
+}
+
+# A variant cannot be checked without the sequential energy, so it fails
+# without being run
+no_reference() {
+    printf "Running %-20s s=%-4s i=%-6s T=%-5s ... " "$1" "$2" "$3" "$4"
+    echo "NO_REFERENCE (the sequential run failed or printed no energy)"
+    FAILED=$((FAILED + 1))
+    echo "$1,$2,$3,$4,,,,,,,,,,NO_REFERENCE" >> "$RESULT_FILE"
+}
+
+echo "variant,size,iterations,tile,iteration_count,wall_s,elapsed_s,fom_zps,origin_energy,reference_energy,rel_err,arts_reference_energy,arts_rel_err,status" > "$RESULT_FILE"
+
+for size in $SIZES; do
+    for iters in $ITERATIONS; do
+        # Sequential reference for this point
+        run_variant sequential "$size" "$iters" - -
+        ref_energy="$LAST_ENERGY"
+        # The first passing ARTS run of this point
+        arts_energy=""
+
+        for variant in $VARIANTS; do
+            [[ "$variant" == "sequential" ]] && continue
+            grains="$(variant_grains "$variant")"
+            for tile in ${grains:--}; do
+                if [[ -z "$ref_energy" ]]; then
+                    no_reference "$variant" "$size" "$iters" "$tile"
+                elif variant_is_arts "$variant"; then
+                    run_variant "$variant" "$size" "$iters" "$tile" "$ref_energy" "${arts_energy:--}"
+                    [[ -z "$arts_energy" ]] && arts_energy="$LAST_ENERGY"
+                else
+                    run_variant "$variant" "$size" "$iters" "$tile" "$ref_energy"
+                fi
+            done
+        done
+    done
+done
+
+echo ""
+echo "================================================================================"
+echo "                        LULESH CROSS-VARIANT RESULTS"
+echo "================================================================================"
+column -t -s, "$RESULT_FILE" 2>/dev/null || cat "$RESULT_FILE"
+echo "--------------------------------------------------------------------------------"
+echo "Passed: $PASSED  Failed/diverged: $FAILED  Skipped: $SKIPPED  (tolerance $REL_TOL, ARTS $ARTS_TOL)"
+echo "Results written to $RESULT_FILE"
+echo "================================================================================"
+# Exit statuses wrap at 256, so any number of failures is reported as 1
+exit $((FAILED > 0 ? 1 : 0))
@@ -0,0 +1,157 @@
+#!/bin/bash
+# OCR API microbenchmark thread sweep
+#
+# Runs apps/ocr/microbench (ocr_microbench) once per worker count, each
+# time with a copy of the ARTS config whose threads= is replaced, and
+# collects its per-benchmark JSON lines into one JSONL file. Every record
+# gets the thread count, run time stamp and git revision added, so runs
+# from different revisions of the shim can be compared directly.
+#
+# Afterwards, tables of throughput (M ops/s) and issuing-EDT latency (ns/op)
+# per benchmark and thread count are printed.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+export LD_LIBRARY_PATH="$PROJECT_ROOT/install/lib:$LD_LIBRARY_PATH"
+
+# Executable (overridable, e.g. by the ocr_microbench_run CMake target)
+OCR_MICROBENCH="${OCR_MICROBENCH:-$PROJECT_ROOT/install/bin/ocr_microbench}"
+
+BASE_CONFIG="${artsConfig:-$SCRIPT_DIR/arts.cfg}"
+THREADS="1 2 4 8 16 32 64"
+OPS=""
+BENCHES=""
+EXTRA_ARGS=""
+RESULT_FILE="$PROJECT_ROOT/ocr_microbench.jsonl"
+
+usage() {
+    echo "Usage: $0 [options]"
+    echo "  -t \"<counts>\"     Worker thread counts (default: \"$THREADS\")"
+    echo "  -n <ops>          Operations per benchmark (default: the binary's)"
+    echo "  -b <names>        Comma-separated benchmarks (default: all)"
+    echo "  -x \"<args>\"       Extra ocr_microbench arguments (e.g. \"-s 4096 -k 8\")"
+    echo "  -c <file>         Base ARTS config (default: $BASE_CONFIG)"
+    echo "  -o <file>         Result file (default: $RESULT_FILE)"
+    exit 1
+}
+
+while getopts "t:n:b:x:c:o:h" opt; do
+    case $opt in
+        t) THREADS="$OPTARG" ;;
+        n) OPS="$OPTARG" ;;
+        b) BENCHES="$OPTARG" ;;
+        x) EXTRA_ARGS="$OPTARG" ;;
+        c) BASE_CONFIG="$OPTARG" ;;
+        o) RESULT_FILE="$OPTARG" ;;
+        *) usage ;;
+    esac
+done
+
+if [ ! -x "$OCR_MICROBENCH" ]; then
+    echo "ocr_microbench not found: $OCR_MICROBENCH (build the ocr_microbench target)"
+    exit 1
+fi
+if [ ! -f "$BASE_CONFIG" ]; then
+    echo "ARTS config not found: $BASE_CONFIG"
+    exit 1
+fi
+
+RUN_TIMESTAMP="$(date -u +%Y-%m-%dT%H:%M:%SZ)"
+GIT_REVISION="$(git -C "$PROJECT_ROOT" rev-parse --short HEAD 2>/dev/null || echo unknown)"
+if [[ "$GIT_REVISION" != "unknown" ]] && ! git -C "$PROJECT_ROOT" diff --quiet HEAD 2>/dev/null; then
+    GIT_REVISION="$GIT_REVISION-dirty"
+fi
+
+ARGS=(-j)
+[[ -n "$OPS" ]] && ARGS+=(-n "$OPS")
+[[ -n "$BENCHES" ]] && ARGS+=(-b "$BENCHES")
+ARGS+=($EXTRA_ARGS)
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# make_config <threads> <file>: base config with threads= replaced, or
+# appended when the base config does not set it
+make_config() {
+    cp "$BASE_CONFIG" "$2"
+    if grep -q "^[[:space:]]*threads[[:space:]]*=" "$2"; then
+        sed -i "s|^[[:space:]]*threads[[:space:]]*=.*|threads=$1|" "$2"
+    else
+        echo "threads=$1" >> "$2"
+    fi
+}
+
+: > "$RESULT_FILE"
+FAILED=0
+
+for threads in $THREADS; do
+    cfg="$WORK_DIR/arts-$threads.cfg"
+    log="$WORK_DIR/run-$threads.log"
+    make_config "$threads" "$cfg"
+
+    printf "Running ocr_microbench with %3s threads ... " "$threads"
+    exec_result=0
+    artsConfig="$cfg" "$OCR_MICROBENCH" "${ARGS[@]}" > "$log" 2>&1 || exec_result=$?
+
+    prefix="{\"threads\":$threads,\"timestamp\":\"$RUN_TIMESTAMP\",\"git_revision\":\"$GIT_REVISION\","
+    count=$(grep -c '^{"bench"' "$log")
+    grep '^{"bench"' "$log" | sed "s|^{|$prefix|" >> "$RESULT_FILE"
+
+    if [[ $exec_result -ne 0 || $count -eq 0 ]]; then
+        FAILED=$((FAILED + 1))
+        echo "FAIL (exit $exec_result, $count benchmarks reported)"
+        tail -5 "$log" | sed 's/^/    /'
+    else
+        echo "$count benchmarks"
+    fi
+done
+
+# print_table <field> <title>: benchmark x thread count matrix of <field>
+print_table() {
+    awk -v field="$2" -v title="$1" '
+        function value(line, key,    re) {
+            re = "\"" key "\":"
+            if (!match(line, re "[^,}]*")) return ""
+            return substr(line, RSTART + length(re), RLENGTH - length(re))
+        }
+        {
+            bench = value($0, "bench"); gsub(/"/, "", bench)
+            t = value($0, "threads") + 0
+            if (!(bench in seen)) { seen[bench] = 1; order[++nb] = bench }
+            if (!(t in tseen)) { tseen[t] = 1; threads[++nt] = t }
+            v = value($0, field)
+            cell[bench, t] = (v == "" || v == "null") ? "-" : v
+        }
+        END {
+            if (nb == 0) exit
+            for (i = 1; i <= nt; i++)
+                for (j = i + 1; j <= nt; j++)
+                    if (threads[j] < threads[i]) { x = threads[i]; threads[i] = threads[j]; threads[j] = x }
+            print title
+            printf "%-20s", "benchmark"
+            for (i = 1; i <= nt; i++) printf " %10s", threads[i] "t"
+            printf "\n"
+            for (b = 1; b <= nb; b++) {
+                printf "%-20s", order[b]
+                for (i = 1; i <= nt; i++) {
+                    c = ((order[b], threads[i]) in cell) ? cell[order[b], threads[i]] : "-"
+                    printf " %10s", c
+                }
+                printf "\n"
+            }
+            printf "\n"
+        }' "$RESULT_FILE"
+}
+
+echo ""
+echo "================================================================================"
+echo "                      OCR API MICROBENCHMARK RESULTS"
+echo "================================================================================"
+print_table "Throughput (M ops/s)" throughput_mops
+print_table "Issuing-EDT latency (ns/op)" latency_ns
+echo "--------------------------------------------------------------------------------"
+echo "Failed runs: $FAILED"
+echo "Results written to $RESULT_FILE"
+echo "================================================================================"
+exit $FAILED
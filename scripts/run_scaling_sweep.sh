@@ -0,0 +1,333 @@
+#!/bin/bash
+# Thread/node scaling sweep over arts.cfg variants
+#
+# Writes one arts.cfg per point of a parameter grid (every combination of
+# the -p values, all other settings taken from the base config), runs the
+# selected apps against each through run_all_apps.sh benchmark mode, and
+# turns the median run times into scaling tables along one axis of the
+# grid (threads by default). Points that differ only in the axis value form
+# one series; every other grid parameter gives a separate table.
+#
+#   strong  apps keep their listed arguments; speedup is T(base) / T(n) and
+#           parallel efficiency is speedup * base / n
+#   weak    apps given with -W run with arguments that grow with n;
+#           efficiency is T(base) / T(n)
+#
+# base is the smallest axis value with a passing run. An app "scales to" the
+# last axis value before its efficiency first drops below -e.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+BASE_CONFIG="$SCRIPT_DIR/arts.cfg"
+AXIS="threads"
+APPS=""
+REPEATS=3
+WARMUP=1
+MIN_EFFICIENCY="0.5"
+OUT_DIR="$PROJECT_ROOT/scaling_sweep"
+
+declare -a GRID
+declare -a WEAK
+
+usage() {
+    echo "Usage: $0 [options]"
+    echo "  -p <key>=<v1,v2,...>  Grid values for an arts.cfg key (repeatable;"
+    echo "                        default: threads=1,2,4,8,16,32,64)"
+    echo "  -x <key>              Scaling axis, one of the -p keys (default: $AXIS)"
+    echo "  -a \"<apps>\"           Apps for strong scaling, by executable name (default: all)"
+    echo "  -W <app>=<args>       Weak-scaling app (repeatable); {expr} in <args> is"
+    echo "                        evaluated with n = axis value, e.g. -W 'comd-ocrd=-x {24*n}'"
+    echo "  -r <reps>             Timed runs per app and point (default: $REPEATS)"
+    echo "  -w <n>                Warm-up runs per app and point (default: $WARMUP)"
+    echo "  -e <eff>              Efficiency below which an app stops scaling (default: $MIN_EFFICIENCY)"
+    echo "  -c <file>             Base config (default: $BASE_CONFIG)"
+    echo "  -o <dir>              Output directory (default: $OUT_DIR)"
+    exit 1
+}
+
+while getopts "p:x:a:W:r:w:e:c:o:h" opt; do
+    case $opt in
+        p) GRID+=("$OPTARG") ;;
+        x) AXIS="$OPTARG" ;;
+        a) APPS="$OPTARG" ;;
+        W) WEAK+=("$OPTARG") ;;
+        r) REPEATS="$OPTARG" ;;
+        w) WARMUP="$OPTARG" ;;
+        e) MIN_EFFICIENCY="$OPTARG" ;;
+        c) BASE_CONFIG="$OPTARG" ;;
+        o) OUT_DIR="$OPTARG" ;;
+        *) usage ;;
+    esac
+done
+
+if [ ${#GRID[@]} -eq 0 ]; then
+    GRID=("threads=1,2,4,8,16,32,64")
+fi
+
+axis_found=false
+for spec in "${GRID[@]}"; do
+    if [[ "$spec" != *=* || -z "${spec#*=}" ]]; then
+        echo "Error: -p expects <key>=<v1,v2,...>, got '$spec'"
+        exit 1
+    fi
+    [[ "${spec%%=*}" == "$AXIS" ]] && axis_found=true
+done
+if [[ "$axis_found" == "false" ]]; then
+    echo "Error: scaling axis '$AXIS' is not one of the -p keys"
+    exit 1
+fi
+if [ ! -f "$BASE_CONFIG" ]; then
+    echo "Error: base config not found: $BASE_CONFIG"
+    exit 1
+fi
+
+mkdir -p "$OUT_DIR/cfg" "$OUT_DIR/results" "$OUT_DIR/logs"
+OUT_DIR="$(cd "$OUT_DIR" && pwd)"
+
+#==============================================================================
+# Grid
+#==============================================================================
+
+# Every combination, each as space-separated key=value pairs
+POINTS=("")
+for spec in "${GRID[@]}"; do
+    key="${spec%%=*}"
+    declare -a next=()
+    IFS=, read -r -a values <<< "${spec#*=}"
+    for point in "${POINTS[@]}"; do
+        for value in "${values[@]}"; do
+            next+=("${point:+$point }$key=$value")
+        done
+    done
+    POINTS=("${next[@]}")
+    unset next
+done
+
+point_name() {
+    local name="${1// /_}"
+    echo "${name//=/-}"
+}
+
+point_value() {
+    local kv
+    for kv in $1; do
+        [[ "${kv%%=*}" == "$2" ]] && echo "${kv#*=}"
+    done
+}
+
+# The point without its axis setting; names the series it belongs to
+point_series() {
+    local kv series=""
+    for kv in $1; do
+        [[ "${kv%%=*}" == "$AXIS" ]] || series="${series:+$series }$kv"
+    done
+    echo "${series:--}"
+}
+
+# make_config <point> <file>: base config with the point's keys replaced,
+# or appended when the base config does not set them
+make_config() {
+    local kv key
+    cp "$BASE_CONFIG" "$2"
+    for kv in $1; do
+        key="${kv%%=*}"
+        if grep -q "^[[:space:]]*$key[[:space:]]*=" "$2"; then
+            sed -i "s|^[[:space:]]*$key[[:space:]]*=.*|$kv|" "$2"
+        else
+            echo "$kv" >> "$2"
+        fi
+    done
+}
+
+# Expands every {expr} in a weak-scaling argument template for n
+weak_args() {
+    awk -v t="$1" -v n="$2" 'BEGIN {
+        while (match(t, /\{[^}]*\}/)) {
+            start = RSTART; len = RLENGTH     # eval() calls match() too
+            out = out substr(t, 1, start - 1)
+            out = out eval(substr(t, start + 1, len - 2), n)
+            t = substr(t, start + len)
+        }
+        print out t
+    }
+    # n, numbers, + - * / ^ and parentheses; int() rounds down
+    function eval(e, n,    r) { gsub(/[[:space:]]/, "", e); pos = 1; src = e; r = expr_(); return r + 0 }
+    function peek() { return substr(src, pos, 1) }
+    function expr_(   v, op) {
+        v = term()
+        while ((op = peek()) == "+" || op == "-") { pos++; v = (op == "+") ? v + term() : v - term() }
+        return v
+    }
+    function term(   v, op) {
+        v = power()
+        while ((op = peek()) == "*" || op == "/") { pos++; v = (op == "*") ? v * power() : v / power() }
+        return v
+    }
+    function power(   v) {
+        v = unary()
+        if (peek() == "^") { pos++; v = v ^ power() }
+        return v
+    }
+    function unary(   v) {
+        if (peek() == "-") { pos++; return -unary() }
+        if (substr(src, pos, 4) == "int(") { pos += 4; v = expr_(); pos++; return int(v) }
+        if (peek() == "(") { pos++; v = expr_(); pos++; return v }
+        if (peek() == "n") { pos++; return n }
+        match(substr(src, pos), /^[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?/)
+        v = substr(src, pos, RLENGTH); pos += RLENGTH
+        return v + 0
+    }'
+}
+
+#==============================================================================
+# Runs
+#==============================================================================
+
+WEAK_APPS=""
+for spec in "${WEAK[@]}"; do
+    WEAK_APPS="${WEAK_APPS:+$WEAK_APPS }${spec%%=*}"
+done
+
+# run_point <point> <mode> <results> [run_all_apps options]
+run_point() {
+    local point="$1" mode="$2" results="$3"
+    shift 3
+    local name
+    name="$(point_name "$point")"
+
+    printf "%-40s %-6s ... " "$point" "$mode"
+    artsConfig="$OUT_DIR/cfg/$name.cfg" "$SCRIPT_DIR/run_all_apps.sh" benchmark \
+        -r "$REPEATS" -w "$WARMUP" -o "$results" "$@" > "$OUT_DIR/logs/$name.$mode.log" 2>&1
+    grep -m1 '^TOTAL' "$OUT_DIR/logs/$name.$mode.log" | sed 's/^TOTAL[[:space:]]*//'
+}
+
+echo "Sweeping ${#POINTS[@]} configuration(s) along $AXIS, $REPEATS run(s) + $WARMUP warm-up each"
+echo "Output: $OUT_DIR"
+echo ""
+
+for point in "${POINTS[@]}"; do
+    name="$(point_name "$point")"
+    make_config "$point" "$OUT_DIR/cfg/$name.cfg"
+    rm -f "$OUT_DIR/results/$name".*.jsonl
+
+    # With only weak-scaling apps requested, skip the strong pass
+    if [[ -n "$APPS" || ${#WEAK[@]} -eq 0 ]]; then
+        run_point "$point" strong "$OUT_DIR/results/$name.strong.jsonl" -a "$APPS"
+    fi
+
+    if [ ${#WEAK[@]} -gt 0 ]; then
+        n="$(point_value "$point" "$AXIS")"
+        overrides=()
+        for spec in "${WEAK[@]}"; do
+            overrides+=(-A "${spec%%=*}=$(weak_args "${spec#*=}" "$n")")
+        done
+        run_point "$point" weak "$OUT_DIR/results/$name.weak.jsonl" -a "$WEAK_APPS" "${overrides[@]}"
+    fi
+done
+
+#==============================================================================
+# Scaling tables
+#==============================================================================
+
+# One line per app, series and axis value:
+#   mode <TAB> series <TAB> n <TAB> app <TAB> median|FAIL
+# Strong-scaling apps are keyed by name and arguments, since run_all_apps.sh
+# lists some apps several times; weak-scaling arguments change with n.
+summarize_results() {
+    local mode="$1" series="$2" n="$3" file="$4"
+    [ -s "$file" ] || return 0
+
+    awk -v mode="$mode" -v series="$series" -v n="$n" '
+        function field(line, key,    m) {
+            if (match(line, "\"" key "\":\"([^\"\\\\]|\\\\.)*\"")) {
+                m = substr(line, RSTART + length(key) + 4, RLENGTH - length(key) - 5)
+                gsub(/\\"/, "\"", m); gsub(/\\\\/, "\\", m)
+                return m
+            }
+            if (match(line, "\"" key "\":[^,}]*"))
+                return substr(line, RSTART + length(key) + 3, RLENGTH - length(key) - 3)
+            return ""
+        }
+        {
+            status = field($0, "status")
+            if (status != "PASS" && status != "FAIL") next
+            key = field($0, "app")
+            if (mode == "strong" && field($0, "args") != "") key = key " " field($0, "args")
+            if (!(key in seen)) { seen[key] = 1; order[++nkeys] = key }
+            if (status == "FAIL") failed[key] = 1
+            else if (field($0, "outlier") != "true") t[key, ++count[key]] = field($0, "wall_s")
+        }
+        END {
+            for (i = 1; i <= nkeys; i++) {
+                key = order[i]; c = count[key]
+                if (failed[key] || c == 0) { printf "%s\t%s\t%s\t%s\tFAIL\n", mode, series, n, key; continue }
+                for (a = 2; a <= c; a++)
+                    for (b = a; b > 1 && t[key, b - 1] > t[key, b]; b--) { x = t[key, b]; t[key, b] = t[key, b - 1]; t[key, b - 1] = x }
+                med = (c % 2) ? t[key, (c + 1) / 2] : (t[key, c / 2] + t[key, c / 2 + 1]) / 2
+                printf "%s\t%s\t%s\t%s\t%.3f\n", mode, series, n, key, med
+            }
+        }' "$file"
+}
+
+SUMMARY="$OUT_DIR/summary.tsv"
+: > "$SUMMARY"
+for point in "${POINTS[@]}"; do
+    name="$(point_name "$point")"
+    for mode in strong weak; do
+        summarize_results "$mode" "$(point_series "$point")" "$(point_value "$point" "$AXIS")" \
+            "$OUT_DIR/results/$name.$mode.jsonl" >> "$SUMMARY"
+    done
+done
+
+SCALING_CSV="$OUT_DIR/scaling.csv"
+echo ""
+awk -F'\t' -v axis="$AXIS" -v min_eff="$MIN_EFFICIENCY" -v csv="$SCALING_CSV" '
+    {
+        if (!(($1, $2) in seen_table)) { seen_table[$1, $2] = 1; tables[++ntables] = $1 SUBSEP $2 }
+        if (!(($1, $2, $4) in seen_app)) { seen_app[$1, $2, $4] = 1; apps[$1, $2, ++napps[$1, $2]] = $4 }
+        if (!(($1, $2, $3) in seen_n)) { seen_n[$1, $2, $3] = 1; ns[$1, $2, ++nn[$1, $2]] = $3 }
+        time[$1, $2, $3, $4] = $5
+    }
+    END {
+        print "mode,series,app," axis ",median_s,speedup,efficiency" > csv
+        for (ti = 1; ti <= ntables; ti++) {
+            split(tables[ti], tk, SUBSEP); mode = tk[1]; series = tk[2]; m = nn[mode, series]
+            for (i = 1; i <= m; i++) v[i] = ns[mode, series, i]
+            for (i = 2; i <= m; i++)
+                for (j = i; j > 1 && v[j - 1] + 0 > v[j] + 0; j--) { x = v[j]; v[j] = v[j - 1]; v[j - 1] = x }
+
+            printf "%s scaling along %s%s: median time (s) and parallel efficiency\n",
+                   (mode == "strong") ? "Strong" : "Weak", axis, (series == "-") ? "" : " (" series ")"
+            printf "%-32s", "Application"
+            for (i = 1; i <= m; i++) printf " %14s", axis "=" v[i]
+            printf "  %s\n", "Scales to"
+
+            for (ai = 1; ai <= napps[mode, series]; ai++) {
+                app = apps[mode, series, ai]
+                base = ""
+                for (i = 1; i <= m; i++)
+                    if (((mode, series, v[i], app) in time) && time[mode, series, v[i], app] != "FAIL") { base = i; break }
+
+                printf "%-32s", (length(app) > 32) ? substr(app, 1, 29) "..." : app
+                limit = ""; stopped = 0
+                for (i = 1; i <= m; i++) {
+                    key = mode SUBSEP series SUBSEP v[i] SUBSEP app
+                    if (!(key in time)) { printf " %14s", "-"; continue }
+                    if (time[key] == "FAIL" || base == "") { printf " %14s", "FAIL"; stopped = 1; continue }
+                    tb = time[mode, series, v[base], app]; t = time[key]
+                    speedup = (t > 0) ? tb / t : 0
+                    eff = (mode == "strong") ? speedup * v[base] / v[i] : speedup
+                    printf " %8.3f %4.0f%%", t, 100 * eff
+                    printf "%s,\"%s\",\"%s\",%s,%.3f,%.3f,%.3f\n", mode, series, app, v[i], t, speedup, eff >> csv
+                    if (!stopped && eff >= min_eff) limit = v[i]; else stopped = 1
+                }
+                printf "  %s\n", (limit == "") ? "-" : axis "=" limit
+            }
+            print ""
+        }
+        if (ntables == 0) print "No passing or failing runs to report (were the apps built?)"
+    }' "$SUMMARY"
+
+echo "Per-point configs: $OUT_DIR/cfg  results: $OUT_DIR/results  logs: $OUT_DIR/logs"
+echo "Scaling table: $SCALING_CSV (efficiency threshold $MIN_EFFICIENCY)"
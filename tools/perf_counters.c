@@ -0,0 +1,174 @@
+/******************************************************************************
+ * perf_counters - Hardware Counters for One Command (run_all_apps.sh -P)
+ *
+ * Usage: perf_counters -o <file> -- <command> [args...]
+ *
+ * Runs the command and writes its counter totals to <file>, one key=value
+ * line per counter. The value is empty when the counter is unavailable
+ * (no PMU in a VM, perf_event_paranoid, unsupported event). Exits with
+ * the command's status.
+ *
+ * The counters are opened on the child before it execs, so they cover
+ * exactly the command. They are inherited by every thread it creates, so
+ * all ARTS workers are counted. Each counter is opened on its own rather
+ * than as a group, so one unsupported event does not take the others
+ * with it. When the kernel multiplexes the counters, values are scaled by
+ * enabled/running time, as perf stat does. Kernel-side counting is tried
+ * first and dropped to user-only if perf_event_paranoid refuses it.
+ ******************************************************************************/
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+typedef struct Counter {
+    const char *name;           // Key in the output file
+    uint32_t type;
+    uint64_t config;
+    int fd;
+    int user_only;
+} Counter;
+
+static Counter counters[] = {
+    {"cycles",           PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,       -1, 0},
+    {"instructions",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,     -1, 0},
+    // The generic cache-miss event is the last-level cache on x86 PMUs
+    {"llc_misses",       PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,     -1, 0},
+    {"branch_misses",    PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,    -1, 0},
+    {"context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, -1, 0},
+};
+
+#define NUM_COUNTERS (sizeof(counters) / sizeof(counters[0]))
+
+static int openCounter(Counter *counter, pid_t pid) {
+    struct perf_event_attr attr;
+
+    for (int user_only = 0; user_only <= 1; user_only++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = counter->type;
+        attr.config = counter->config;
+        attr.disabled = 1;
+        attr.enable_on_exec = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = user_only;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counter->fd = (int)syscall(SYS_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (counter->fd >= 0) {
+            counter->user_only = user_only;
+            return 1;
+        }
+        if (errno != EACCES && errno != EPERM)
+            break;
+    }
+    return 0;
+}
+
+// Returns 0 if the counter never ran (unavailable or starved)
+static int readCounter(const Counter *counter, uint64_t *value) {
+    uint64_t data[3];       // value, time enabled, time running
+
+    if (counter->fd < 0 || read(counter->fd, data, sizeof(data)) != (ssize_t)sizeof(data))
+        return 0;
+    if (data[2] == 0)
+        return 0;
+
+    *value = data[2] < data[1] ? (uint64_t)((double)data[0] * data[1] / data[2]) : data[0];
+    return 1;
+}
+
+static void usage(const char *progname) {
+    fprintf(stderr, "Usage: %s -o <file> -- <command> [args...]\n", progname);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+    int cmd = 1;
+
+    for (; cmd < argc; cmd++) {
+        if (strcmp(argv[cmd], "-o") == 0 && cmd + 1 < argc) {
+            out_path = argv[++cmd];
+        } else if (strcmp(argv[cmd], "--") == 0) {
+            cmd++;
+            break;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (!out_path || cmd >= argc)
+        usage(argv[0]);
+
+    // The child waits on the pipe until its counters are open
+    int go[2];
+    if (pipe(go) != 0) {
+        perror("pipe");
+        return 2;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 2;
+    }
+    if (pid == 0) {
+        char c;
+        close(go[1]);
+        if (read(go[0], &c, 1) != 1)
+            _exit(127);
+        close(go[0]);
+        execvp(argv[cmd], &argv[cmd]);
+        fprintf(stderr, "perf_counters: cannot run %s: %s\n", argv[cmd], strerror(errno));
+        _exit(127);
+    }
+
+    close(go[0]);
+    for (size_t i = 0; i < NUM_COUNTERS; i++)
+        openCounter(&counters[i], pid);
+    if (write(go[1], "x", 1) != 1) {
+        perror("write");
+        kill(pid, SIGKILL);
+    }
+    close(go[1]);
+
+    // Ctrl-C reaches the command through the process group; outlive it so
+    // the counters of an interrupted run are still written
+    signal(SIGINT, SIG_IGN);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            perror("waitpid");
+            return 2;
+        }
+    }
+
+    FILE *out = fopen(out_path, "w");
+    if (!out) {
+        perror(out_path);
+    } else {
+        for (size_t i = 0; i < NUM_COUNTERS; i++) {
+            uint64_t value;
+            if (readCounter(&counters[i], &value))
+                fprintf(out, "%s=%llu\n", counters[i].name, (unsigned long long)value);
+            else
+                fprintf(out, "%s=\n", counters[i].name);
+            if (counters[i].user_only)
+                fprintf(out, "%s_user_only=1\n", counters[i].name);
+        }
+        fclose(out);
+    }
+
+    if (WIFSIGNALED(status))
+        return 128 + WTERMSIG(status);
+    return WEXITSTATUS(status);
+}